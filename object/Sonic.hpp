@@ -1,9 +1,7 @@
 // Created by Lua (TeamPuzel) on August 11th 2025.
 // Copyright (c) 2025 All rights reserved.
 #pragma once
-#include <iomanip>
 #include <sonic>
-#include <sstream>
 #include "pickup/Ring.hpp"
 
 namespace sonic {
@@ -51,9 +49,9 @@ namespace sonic {
             Hurt,
         };
 
-        mutable Animator<Animation> animator {};
-        mutable bool mirror_x { false };
-        mutable i32 anim_x { 0 }, anim_y { 6 };
+        Animator<Animation> animator {};
+        bool mirror_x { false };
+        i32 anim_x { 0 }, anim_y { 6 };
 
         auto ground_sensor_mode() const noexcept -> Mode {
             if (ground_angle >= 315 and ground_angle <= 45) {
@@ -587,7 +585,7 @@ namespace sonic {
             }
         }
 
-        auto sprite(rt::Input const& input) const noexcept -> Sprite override {
+        void animate(rt::Input const& input) noexcept override {
             using rt::Key;
 
             if (damage_state != DamageState::FlyingBack) {
@@ -657,7 +655,9 @@ namespace sonic {
                     animator.update();
                 }
             }
+        }
 
+        auto sprite(rt::Input const& input) const noexcept -> Sprite override {
             return Sprite {
                 anim_x + (i32) animator.at(), anim_y,
                 64, 64,
@@ -675,44 +675,30 @@ namespace sonic {
             }
         }
 
-        void hud_draw(Io& io, Ref<Image> target, Stage const& stage) const noexcept override {
-            std::stringstream hud_string;
-            hud_string
-                << "SCORE  " << std::setw(7) << score << std::endl
-                << "TIME  " << timer / 60 << ":" << std::setfill('0') << std::setw(2) << timer % 60 << std::endl
-                << "RINGS  " << std::setfill(' ') << std::setw(3) << rings << std::endl;
-
-            constexpr Color HUD_YELLOW = Color::rgba(255, 255, 10);
-
-            std::string line;
-            for (i32 y = 8; std::getline(hud_string, line); y += font::mine(io).height + 5) {
-                target
-                    | draw::draw(Text(line, font::sonic(io), draw::color::BLACK), 8 + 1, y + 1)
-                    | draw::draw(Text(line, font::sonic(io), draw::color::BLACK), 8 + 1, y)
-                    | draw::draw(Text(line, font::sonic(io), HUD_YELLOW), 8, y);
-            }
+        auto hud() const noexcept -> std::optional<Hud> override {
+            return Hud { score, timer, rings };
         }
 
-        void debug_draw(Io& io, std::stringstream& out, draw::Slice<Ref<Image>> target, Stage const& stage) const noexcept override {
+        void debug_draw(DebugText& out, draw::Slice<DebugCanvas> target, Stage const& stage) const noexcept override {
             auto [ppx, ppy] = pixel_pos();
 
             auto aligned_target = target
                 .shift(ppx, ppy);
 
-            out << "Sonic:" << std::endl
-                << "ground angle: " << (u16) ground_angle << std::endl
-                << "speed: x: " << speed.x << " y: " << speed.y << std::endl
-                << "ground speed: " << ground_speed << std::endl;
+            out << "Sonic:" << '\n'
+                << "ground angle: " << (u16) ground_angle << '\n'
+                << "speed: x: " << speed.x << " y: " << speed.y << '\n'
+                << "ground speed: " << ground_speed << '\n';
 
             switch (state) {
-                case State::Normal:   out << "state: Normal"   << std::endl; break;
-                case State::Rolling:  out << "state: Rolling"  << std::endl; break;
-                case State::Airborne: out << "state: Airborne" << std::endl; break;
+                case State::Normal:   out << "state: Normal"   << '\n'; break;
+                case State::Rolling:  out << "state: Rolling"  << '\n'; break;
+                case State::Airborne: out << "state: Airborne" << '\n'; break;
             }
 
             // As usual C++ is taking what was perfectly sound in C (formatting) and making stupid, error prone assumptions.
             // I wish I at least had std::format but this is decade old C++17, ugh.
-            out << "control lock: " << (u16) control_lock << std::endl;
+            out << "control lock: " << (u16) control_lock << '\n';
 
             target
                 | draw::line(ppx, ppy, ppx + (i32) speed.x * 3, ppy + (i32) speed.y * 3)
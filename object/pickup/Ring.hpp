@@ -101,7 +101,7 @@ namespace sonic {
             return Sprite { (is_collected ? 4 : 0) + 12 + ((i32) input.counter() / animation_step() % 4), 12, 16, 16 };
         }
 
-        void debug_draw(Io& io, std::stringstream& out, draw::Slice<Ref<Image>> target, Stage const& stage) const noexcept override {
+        void debug_draw(DebugText& out, draw::Slice<DebugCanvas> target, Stage const& stage) const noexcept override {
             if (is_scattered) {
                 auto [ppx, ppy] = pixel_pos();
 
@@ -0,0 +1,202 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines fonts resolved into an atlas of their glyphs, for drawing text without an image per string.
+#pragma once
+#include <primitive>
+#include <array>
+#include <vector>
+#include <span>
+#include <string_view>
+#include "color.hpp"
+#include "plane.hpp"
+#include "image.hpp"
+#include "text.hpp"
+
+namespace draw {
+    /// A font with every one of its 256 characters resolved once into a table of glyphs, their pixels laid out
+    /// side by side in a single image.
+    ///
+    /// Text is drawn glyph by glyph straight into the target, exactly as a Text drawn with the binary blend would
+    /// look, without ever rendering an image of the string. The positions of the glyphs of a line are kept
+    /// by the hash of the line, so text which stays the same between frames is only laid out once.
+    ///
+    /// Colors are applied while drawing, so a line drawn in several colors like a shadow is laid out once.
+    /// Nothing is allocated past making the atlas, so text can be drawn every frame for free.
+    /// This type is not thread-safe, like the Text cache it is meant to be used from const drawing code.
+    class GlyphAtlas final {
+      public:
+        struct Glyph final {
+            /// Where the pixels of the glyph start in the atlas.
+            i32 x { 0 };
+            i32 width { 0 };
+            /// Spaces have a width but nothing to draw.
+            bool space { true };
+        };
+
+        /// A line of text with the position of each of its glyphs, stored inline so that laying out never allocates.
+        struct Layout final {
+            struct Placed final {
+                u8 glyph;
+                i16 x;
+            };
+
+            /// Longer lines are not kept and get laid out every time they are drawn instead.
+            static constexpr usize LENGTH = 48;
+
+            FixedString<LENGTH> text;
+            i32 width { 0 };
+            u8 count { 0 };
+            std::array<Placed, LENGTH> glyphs;
+
+            auto placed() const noexcept -> std::span<Placed const> {
+                return std::span(glyphs.data(), count);
+            }
+        };
+
+      private:
+        Image pixels;
+        std::array<Glyph, 256> glyphs;
+        /// Lines are kept in the slot their hash picks, a line landing on a taken slot replaces what was there,
+        /// so text changing every frame costs a layout and never grows the cache.
+        mutable std::vector<Layout> layouts;
+
+        static constexpr usize CAPACITY = 256;
+
+        static auto hash(std::string_view text) noexcept -> u64 {
+            u64 ret = 0xCBF29CE484222325;
+            for (const auto c : text) ret = (ret ^ u8(c)) * 0x100000001B3;
+            return ret;
+        }
+
+        /// Calls the provided function for every glyph of a line which has pixels, with signature:
+        /// (u8 glyph, i32 x) -> void
+        /// Answers with the width of the line.
+        template <typename F> auto walk(std::string_view text, F fn) const -> i32 {
+            i32 width = text.empty() ? 0 : -spacing;
+            i32 cursor = 0;
+            for (const auto c : text) {
+                auto const& glyph = this->glyph(c);
+                if (not glyph.space) {
+                    fn(u8(c), cursor);
+                    cursor += spacing;
+                }
+                cursor += glyph.width;
+                width += glyph.width + spacing;
+            }
+            return width;
+        }
+
+        template <MutableRowPlane T> void blit(T& target, u8 c, i32 left, i32 y, Color color) const {
+            auto const& glyph = glyphs[c];
+
+            for (i32 row = 0; row < height; row += 1) {
+                const auto span = target.row_mut(y + row, left, left + glyph.width);
+                if (span.empty()) continue;
+
+                // The first pixel of the glyph which lands inside the span.
+                const auto source = pixels.raw() + glyph.x + (span.begin - left) + row * pixels.width();
+                for (i32 i = 0; i < span.end - span.begin; i += 1) {
+                    const auto pixel = source[i] == color::WHITE ? color : source[i];
+                    if (pixel.a == 255) span.data[i] = pixel;
+                }
+            }
+        }
+
+      public:
+        i32 height { 0 };
+        i32 spacing { 0 };
+        i32 leading { 0 };
+
+        GlyphAtlas() : layouts(CAPACITY) {}
+
+        template <Plane T> static auto of(Font<T, char> const& font) -> GlyphAtlas {
+            using SymbolType = typename Symbol<T>::Type;
+
+            GlyphAtlas ret;
+            ret.height = font.height;
+            ret.spacing = font.spacing;
+            ret.leading = font.leading;
+
+            i32 total = 0;
+            for (u32 c = 0; c < 256; c += 1) {
+                const auto symbol = font.symbol(char(c));
+                if (symbol.type == SymbolType::Glyph) total += symbol.width();
+            }
+
+            ret.pixels = Image(total, font.height);
+            i32 cursor = 0;
+            for (u32 c = 0; c < 256; c += 1) {
+                const auto symbol = font.symbol(char(c));
+                auto& glyph = ret.glyphs[c];
+                glyph.width = symbol.width();
+
+                if (symbol.type == SymbolType::Glyph) {
+                    glyph.x = cursor;
+                    glyph.space = false;
+                    for (i32 y = 0; y < std::min(symbol.glyph.height(), font.height); y += 1) {
+                        for (i32 x = 0; x < glyph.width; x += 1) {
+                            ret.pixels.set(cursor + x, y, symbol.glyph.get(x, y));
+                        }
+                    }
+                    cursor += glyph.width;
+                }
+            }
+            return ret;
+        }
+
+        auto glyph(char c) const noexcept -> Glyph const& {
+            return glyphs[u8(c)];
+        }
+
+        /// Lays out a line, the same way a Text of it is. Lines too long to keep are not laid out.
+        auto layout(std::string_view text) const -> Layout const* {
+            if (text.size() > Layout::LENGTH) return nullptr;
+
+            auto& ret = layouts[hash(text) % CAPACITY];
+            if (ret.text.view() == text) return &ret;
+
+            ret.text = FixedString<Layout::LENGTH>(text);
+            ret.count = 0;
+            ret.width = walk(text, [&] (u8 glyph, i32 x) {
+                ret.glyphs[ret.count++] = { glyph, i16(x) };
+            });
+            return &ret;
+        }
+
+        /// The width of a line, the same as the width of a Text of it.
+        auto width(std::string_view text) const -> i32 {
+            if (const auto line = layout(text)) return line->width;
+            return walk(text, [] (u8, i32) {});
+        }
+
+        /// Draws a line with its top left at the given position. White pixels of the glyphs take the color,
+        /// the rest keep their own and only opaque pixels are drawn.
+        template <MutableRowPlane T> void draw(T& target, std::string_view text, i32 x, i32 y, Color color = color::WHITE) const {
+            if (const auto line = layout(text)) {
+                for (auto const& placed : line->placed()) blit(target, placed.glyph, x + placed.x, y, color);
+            } else {
+                walk(text, [&] (u8 glyph, i32 offset) { blit(target, glyph, x + offset, y, color); });
+            }
+        }
+    };
+
+    namespace adapt {
+        struct Write final {
+            GlyphAtlas const& atlas;
+            std::string_view text;
+            i32 x, y;
+            Color color;
+
+            template <MutableRowPlane T> constexpr T& operator()(T& self) const {
+                atlas.draw(self, text, x, y, color);
+                return self;
+            }
+        };
+    }
+
+    /// Writes a line of text with a glyph atlas.
+    constexpr adapt::Write write(GlyphAtlas const& atlas, std::string_view text, i32 x, i32 y, Color color = color::WHITE) {
+        return adapt::Write { atlas, text, x, y, color };
+    }
+}
@@ -32,9 +32,9 @@ namespace draw {
         template <typename F> Image(i32 width, i32 height, F init) : w(width), h(height) {
             data.reserve(width * height);
             data.resize(width * height);
-            for (i32 x = 0; x < width; x += 1) {
-                for (i32 y = 0; y < height; y += 1) {
-                    data.at(x + y * width) = init(x, y);
+            for (i32 y = 0; y < height; y += 1) {
+                for (i32 x = 0; x < width; x += 1) {
+                    data[x + y * width] = init(x, y);
                 }
             }
         }
@@ -75,6 +75,48 @@ namespace draw {
             }
         }
 
+        auto clip() const noexcept -> ClipRect {
+            return { 0, 0, w, h };
+        }
+
+        /// Only valid within `clip()`.
+        [[clang::always_inline]] auto get_unchecked(i32 x, i32 y) const noexcept -> Color {
+            return data[x + y * w];
+        }
+
+        /// Only valid within `clip()`.
+        [[clang::always_inline]] void set_unchecked(i32 x, i32 y, Color color) noexcept {
+            data[x + y * w] = color;
+        }
+
+        void row(i32 y, i32 x0, i32 x1, Color* out) const noexcept {
+            if (y < 0 or y >= h) {
+                std::fill(out, out + (x1 - x0), color::CLEAR);
+                return;
+            }
+
+            // The stored pixels are the ones from `lo` up to `hi` in the output.
+            const i32 count = x1 - x0;
+            const i32 lo = std::clamp(-x0, 0, count);
+            const i32 hi = std::clamp(w - x0, lo, count);
+            std::fill(out, out + lo, color::CLEAR);
+            if (lo < hi) {
+                // Only formed once it is known to point into the row, `x0` alone may lie before the image.
+                const auto source = data.data() + y * w + x0 + lo;
+                std::copy(source, source + (hi - lo), out + lo);
+            }
+            std::fill(out + hi, out + count, color::CLEAR);
+        }
+
+        auto row_mut(i32 y, i32 x0, i32 x1) noexcept -> RowSpan {
+            if (y < 0 or y >= h) return {};
+
+            const i32 begin = std::max(x0, 0);
+            const i32 end = std::min(x1, w);
+            if (begin >= end) return {};
+            return { data.data() + begin + y * w, begin, end };
+        }
+
         auto raw() const noexcept -> Color const* {
             return data.data();
         }
@@ -84,14 +126,24 @@ namespace draw {
         }
 
         template <SizedPlane U> static auto flatten(U const& other) -> Image {
-            return Image(other.width(), other.height(), [&] (i32 x, i32 y) -> Color {
-                return other.get(x, y);
-            });
+            if constexpr (RowPlane<U>) {
+                auto ret = Image(other.width(), other.height());
+                for (i32 y = 0; y < ret.h; y += 1) {
+                    other.row(y, 0, ret.w, ret.data.data() + y * ret.w);
+                }
+                return ret;
+            } else {
+                return Image(other.width(), other.height(), [&] (i32 x, i32 y) -> Color {
+                    return other.get(x, y);
+                });
+            }
         }
     };
 
     // Assert that our type properly satisfies the desired interface.
     static_assert(SizedPlane<Image> and MutablePlane<Image>);
+    static_assert(RowPlane<Image> and MutableRowPlane<Image>);
+    static_assert(ClippedPlane<Image> and UncheckedPlane<Image>);
 
     class TgaImage final {
         std::vector<u8> data;
@@ -0,0 +1,188 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines row kernels for the built in blend modes.
+//
+// A kernel blends a whole run of pixels over another in place, producing exactly what calling the blend function
+// for each pixel would. There is a scalar version of each which works everywhere and vectorized versions for x86
+// processing 4 (SSE2) or 8 (AVX2) pixels at a time. The best available set is chosen once at startup.
+//
+// Other architectures simply use the scalar kernels which compilers vectorize reasonably well on their own anyway.
+#pragma once
+#include <primitive>
+#include <algorithm>
+#include <type_traits>
+#include "color.hpp"
+
+#if defined(__x86_64__) or defined(_M_X64)
+    #define DRAW_KERNEL_X86 1
+    #include <immintrin.h>
+    #include <cpuid.h>
+#else
+    #define DRAW_KERNEL_X86 0
+#endif
+
+namespace draw::kernel {
+    /// Blends `count` pixels of `top` over `bottom`, storing the result in `bottom`.
+    using RowBlend = void (*) (Color const* top, Color* bottom, i32 count);
+
+    struct Kernels final {
+        RowBlend overwrite;
+        RowBlend binary;
+        RowBlend alpha;
+        char const* name;
+    };
+
+    namespace scalar {
+        inline void overwrite(Color const* top, Color* bottom, i32 count) {
+            std::copy(top, top + count, bottom);
+        }
+
+        inline void binary(Color const* top, Color* bottom, i32 count) {
+            for (i32 i = 0; i < count; i += 1) bottom[i] = blend::binary(top[i], bottom[i]);
+        }
+
+        inline void alpha(Color const* top, Color* bottom, i32 count) {
+            for (i32 i = 0; i < count; i += 1) bottom[i] = blend::alpha(top[i], bottom[i]);
+        }
+    }
+
+#if DRAW_KERNEL_X86
+    // Pixels are stored r, g, b, a in memory so alpha is the top byte of each little endian 32 bit lane.
+    //
+    // Alpha blending divides by 255 exactly like the scalar version. Every intermediate value is at most 255 * 255
+    // so it fits 16 bit lanes, and for those floor(x / 255) is ((x + 1) * 257) >> 16, which is one high multiply.
+    // The alpha channel is computed as (255 * ta + ba * (255 - ta)) / 255 which is exactly ta + ba * (255 - ta) / 255,
+    // so all four channels share the same expression with the top multiplier of the alpha lane fixed at 255.
+
+    namespace sse2 {
+        inline void binary(Color const* top, Color* bottom, i32 count) {
+            const __m128i alpha = _mm_set1_epi32(i32(0xFF000000));
+
+            i32 i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i t = _mm_loadu_si128((__m128i const*) (top + i));
+                const __m128i b = _mm_loadu_si128((__m128i const*) (bottom + i));
+                const __m128i opaque = _mm_cmpeq_epi32(_mm_and_si128(t, alpha), alpha);
+                _mm_storeu_si128((__m128i*) (bottom + i), _mm_or_si128(_mm_and_si128(opaque, t), _mm_andnot_si128(opaque, b)));
+            }
+            scalar::binary(top + i, bottom + i, count - i);
+        }
+
+        [[clang::always_inline]] inline auto alpha_half(__m128i t, __m128i b) -> __m128i {
+            const __m128i full = _mm_set1_epi16(255);
+            const __m128i alpha_lane = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+
+            const __m128i ta = _mm_shufflehi_epi16(_mm_shufflelo_epi16(t, 0xFF), 0xFF);
+            const __m128i inv = _mm_sub_epi16(full, ta);
+            const __m128i mt = _mm_or_si128(_mm_andnot_si128(alpha_lane, ta), _mm_and_si128(alpha_lane, full));
+
+            const __m128i sum = _mm_add_epi16(_mm_mullo_epi16(t, mt), _mm_mullo_epi16(b, inv));
+            return _mm_mulhi_epu16(_mm_add_epi16(sum, _mm_set1_epi16(1)), _mm_set1_epi16(257));
+        }
+
+        inline void alpha(Color const* top, Color* bottom, i32 count) {
+            const __m128i zero = _mm_setzero_si128();
+
+            i32 i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i t = _mm_loadu_si128((__m128i const*) (top + i));
+                const __m128i b = _mm_loadu_si128((__m128i const*) (bottom + i));
+                const __m128i lo = alpha_half(_mm_unpacklo_epi8(t, zero), _mm_unpacklo_epi8(b, zero));
+                const __m128i hi = alpha_half(_mm_unpackhi_epi8(t, zero), _mm_unpackhi_epi8(b, zero));
+                _mm_storeu_si128((__m128i*) (bottom + i), _mm_packus_epi16(lo, hi));
+            }
+            scalar::alpha(top + i, bottom + i, count - i);
+        }
+    }
+
+    namespace avx2 {
+        [[gnu::target("avx2")]] inline void binary(Color const* top, Color* bottom, i32 count) {
+            const __m256i alpha = _mm256_set1_epi32(i32(0xFF000000));
+
+            i32 i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i t = _mm256_loadu_si256((__m256i const*) (top + i));
+                const __m256i b = _mm256_loadu_si256((__m256i const*) (bottom + i));
+                const __m256i opaque = _mm256_cmpeq_epi32(_mm256_and_si256(t, alpha), alpha);
+                _mm256_storeu_si256((__m256i*) (bottom + i), _mm256_blendv_epi8(b, t, opaque));
+            }
+            sse2::binary(top + i, bottom + i, count - i);
+        }
+
+        [[gnu::target("avx2")]] [[clang::always_inline]] inline auto alpha_half(__m256i t, __m256i b) -> __m256i {
+            const __m256i full = _mm256_set1_epi16(255);
+            const __m256i alpha_lane = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+
+            const __m256i ta = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(t, 0xFF), 0xFF);
+            const __m256i inv = _mm256_sub_epi16(full, ta);
+            const __m256i mt = _mm256_blendv_epi8(ta, full, alpha_lane);
+
+            const __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(t, mt), _mm256_mullo_epi16(b, inv));
+            return _mm256_mulhi_epu16(_mm256_add_epi16(sum, _mm256_set1_epi16(1)), _mm256_set1_epi16(257));
+        }
+
+        [[gnu::target("avx2")]] inline void alpha(Color const* top, Color* bottom, i32 count) {
+            const __m256i zero = _mm256_setzero_si256();
+
+            i32 i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const __m256i t = _mm256_loadu_si256((__m256i const*) (top + i));
+                const __m256i b = _mm256_loadu_si256((__m256i const*) (bottom + i));
+                // Unpacking and packing both work within 128 bit halves so the pixel order comes back out intact.
+                const __m256i lo = alpha_half(_mm256_unpacklo_epi8(t, zero), _mm256_unpacklo_epi8(b, zero));
+                const __m256i hi = alpha_half(_mm256_unpackhi_epi8(t, zero), _mm256_unpackhi_epi8(b, zero));
+                _mm256_storeu_si256((__m256i*) (bottom + i), _mm256_packus_epi16(lo, hi));
+            }
+            sse2::alpha(top + i, bottom + i, count - i);
+        }
+    }
+
+    /// AVX2 needs both the processor and the operating system saving the wider registers.
+    inline auto has_avx2() -> bool {
+        u32 a, b, c, d;
+        if (not __get_cpuid(1, &a, &b, &c, &d)) return false;
+
+        const bool osxsave = c & bit_OSXSAVE;
+        const bool avx = c & bit_AVX;
+        if (not osxsave or not avx) return false;
+
+        u32 xcr0_lo, xcr0_hi;
+        __asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+        if ((xcr0_lo & 0b110) != 0b110) return false;
+
+        if (not __get_cpuid_count(7, 0, &a, &b, &c, &d)) return false;
+        return b & bit_AVX2;
+    }
+#endif
+
+    inline auto detect() -> Kernels {
+#if DRAW_KERNEL_X86
+        if (has_avx2()) {
+            return { scalar::overwrite, avx2::binary, avx2::alpha, "avx2" };
+        } else {
+            return { scalar::overwrite, sse2::binary, sse2::alpha, "sse2" };
+        }
+#else
+        return { scalar::overwrite, scalar::binary, scalar::alpha, "scalar" };
+#endif
+    }
+
+    /// The kernels for this processor, detected once.
+    inline auto active() -> Kernels const& {
+        static const Kernels kernels = detect();
+        return kernels;
+    }
+
+    /// Finds the row kernel of a blend mode if it is one of the built in functions.
+    /// Anything else, like a lambda, has to be blended one pixel at a time by the caller.
+    template <typename Blend> inline auto find(Blend const& blend_mode) -> RowBlend {
+        if constexpr (std::is_pointer_v<Blend>) {
+            auto const& kernels = active();
+            if (blend_mode == &blend::overwrite) return kernels.overwrite;
+            if (blend_mode == &blend::binary) return kernels.binary;
+            if (blend_mode == &blend::alpha) return kernels.alpha;
+        }
+        return nullptr;
+    }
+}
@@ -42,6 +42,21 @@
 // - PrimitiveDrawable, a refinement of SizedDrawable which can losslessly be flattened into from another one.
 //     This represents primitives, actual concrete roots of a drawable expression, like the Image or InfiniteImage types.
 //
+// There are also two optional capabilities which exist purely for performance:
+//
+// - RowPlane, a refinement of Drawable which can produce a horizontal run of pixels at once.
+//     Adapters implement it whenever what they wrap does, so entire expressions can be evaluated a row at a time.
+//
+// - MutableRowPlane, a refinement of MutableDrawable which exposes the storage of a row directly.
+//     Only planes with actual contiguous storage underneath, like an Image, can implement this one.
+//
+// - ClippedPlane, a refinement of MutableDrawable which knows the rectangle its pixels are stored in.
+//     Outside of it writes do nothing, so algorithms can intersect with it once and then skip bounds checks
+//     by using the unchecked accessors of an UncheckedPlane.
+//
+// Neither changes what any pixel is, a row is always exactly what getting its pixels one by one would produce,
+// so everything still works with the per-pixel protocol and uses rows only when they are available.
+//
 // Drawables are structurally equal, implementations of equality and hashing must take into account
 // the exact value of every single pixel. Optimizations are allowed, like two red rectangles of the same size
 // being equal just by comparing those parameters rather than computing them for each pixel, but this
@@ -68,6 +83,7 @@
 #include <utility>
 #include <algorithm>
 #include "color.hpp"
+#include "kernel.hpp"
 
 namespace draw {
     enum class Origin {
@@ -98,6 +114,69 @@ namespace draw {
     template <typename Self, typename From> concept PrimitivePlane = SizedPlane<From> and requires(From const& other) {
         { Self::flatten(other) } -> std::same_as<Self>;
     };
+
+    /// The stored part of a requested row, `data` points at the pixel `begin` and the run ends before `end`.
+    /// Pixels of the requested range outside of it are not stored, so writing them would do nothing anyway.
+    struct RowSpan final {
+        Color* data { nullptr };
+        i32 begin { 0 }, end { 0 };
+
+        constexpr auto empty() const noexcept -> bool {
+            return begin >= end;
+        }
+    };
+
+    /// Writes the pixels from `x0` up to but excluding `x1` of the row `y` into `out`, exactly as `get` would produce them.
+    template <typename Self> concept RowPlane = Plane<Self> and requires(Self const& self, i32 x, i32 y, Color* out) {
+        { self.row(y, x, x, out) } -> std::same_as<void>;
+    };
+
+    /// Exposes the storage backing the pixels from `x0` up to but excluding `x1` of the row `y`.
+    template <typename Self> concept MutableRowPlane = MutablePlane<Self> and requires(Self& self, i32 x, i32 y) {
+        { self.row_mut(y, x, x) } -> std::same_as<RowSpan>;
+    };
+
+    /// A rectangle of pixels, used to describe where a plane stores anything at all.
+    struct ClipRect final {
+        i32 x { 0 }, y { 0 }, w { 0 }, h { 0 };
+
+        constexpr auto empty() const noexcept -> bool {
+            return w <= 0 or h <= 0;
+        }
+
+        constexpr auto contains(i32 px, i32 py) const noexcept -> bool {
+            return px >= x and px < x + w and py >= y and py < y + h;
+        }
+
+        constexpr auto intersect(ClipRect other) const noexcept -> ClipRect {
+            const i32 nx = std::max(x, other.x), ny = std::max(y, other.y);
+            const i32 nw = std::min(x + w, other.x + other.w) - nx, nh = std::min(y + h, other.y + other.h) - ny;
+            return { nx, ny, std::max(nw, 0), std::max(nh, 0) };
+        }
+    };
+
+    /// Stores only the pixels within `clip()`, writing outside of it does nothing.
+    template <typename Self> concept ClippedPlane = MutablePlane<Self> and requires(Self const& self) {
+        { self.clip() } -> std::same_as<ClipRect>;
+    };
+
+    /// Provides accessors without bounds checks, only valid within `clip()`.
+    template <typename Self> concept UncheckedPlane = ClippedPlane<Self> and requires(Self& self, i32 x, i32 y, Color color) {
+        { self.get_unchecked(x, y) } -> std::same_as<Color>;
+        { self.set_unchecked(x, y, color) } -> std::same_as<void>;
+    };
+
+    /// How many pixels row based algorithms process at once, small enough for the buffer to live on the stack.
+    constexpr i32 ROW_CHUNK = 256;
+
+    /// Reads a run of pixels from any plane, a row at a time if it can.
+    template <Plane T> [[clang::always_inline]] constexpr void read_row(T const& plane, i32 y, i32 x0, i32 x1, Color* out) {
+        if constexpr (RowPlane<T>) {
+            plane.row(y, x0, x1, out);
+        } else {
+            for (i32 x = x0; x < x1; x += 1) out[x - x0] = plane.get(x, y);
+        }
+    }
 }
 
 /// Performs forwarding adapter composition. Based on the design of std::ranges.
@@ -230,9 +309,14 @@ namespace draw {
             Color color;
 
             template <typename T> constexpr T& operator()(T& self) const requires SizedPlane<T> and MutablePlane<T> {
-                for (i32 x = 0; x < self.width(); x += 1) {
-                    for (i32 y = 0; y < self.height(); y += 1) {
-                        self.set(x, y, color);
+                for (i32 y = 0; y < self.height(); y += 1) {
+                    if constexpr (MutableRowPlane<T>) {
+                        const auto span = self.row_mut(y, 0, self.width());
+                        if (not span.empty()) std::fill_n(span.data, span.end - span.begin, color);
+                    } else {
+                        for (i32 x = 0; x < self.width(); x += 1) {
+                            self.set(x, y, color);
+                        }
                     }
                 }
                 return self;
@@ -257,7 +341,35 @@ namespace draw {
             i32 sx, sy, dx, dy;
             Color color;
 
+            /// A line entirely outside of a clipped target is skipped and one entirely inside skips bounds checks.
+            /// Horizontal and vertical lines, like the ones of sensors, are cut down to the visible part first.
             template <MutablePlane T> constexpr T& operator()(T& self) const {
+                if constexpr (UncheckedPlane<T>) {
+                    const auto clip = self.clip();
+                    const auto bounds = ClipRect {
+                        std::min(sx, dx), std::min(sy, dy), std::abs(dx - sx) + 1, std::abs(dy - sy) + 1
+                    };
+                    const auto visible = bounds.intersect(clip);
+
+                    if (visible.empty()) return self;
+                    if (visible.w == bounds.w and visible.h == bounds.h) {
+                        walk([&] (i32 x, i32 y) { self.set_unchecked(x, y, color); });
+                        return self;
+                    }
+                    if (sx == dx or sy == dy) {
+                        for (i32 y = visible.y; y < visible.y + visible.h; y += 1) {
+                            for (i32 x = visible.x; x < visible.x + visible.w; x += 1) self.set_unchecked(x, y, color);
+                        }
+                        return self;
+                    }
+                }
+
+                walk([&] (i32 x, i32 y) { self.set(x, y, color); });
+                return self;
+            }
+
+          private:
+            template <typename F> constexpr void walk(F plot) const {
                 i32 x0 = sx;
                 i32 y0 = sy;
                 i32 x1 = dx;
@@ -270,7 +382,7 @@ namespace draw {
                 i32 err = delta_x - delta_y;
 
                 while (true) {
-                    self.set(x0, y0, color);
+                    plot(x0, y0);
 
                     if (x0 == x1 && y0 == y1) break;
                     i32 e2 = 2 * err;
@@ -283,8 +395,6 @@ namespace draw {
                         y0 += step_y;
                     }
                 }
-
-                return self;
             }
         };
 
@@ -296,16 +406,62 @@ namespace draw {
             constexpr Draw(D const& drawable, i32 x, i32 y, Blend blend_mode)
                 : drawable(drawable), x(x), y(y), blend_mode(blend_mode) {}
 
+            /// Works in rows so that both the drawable and the target are walked in the order they are stored.
+            /// When the target exposes its rows only the stored part of each is evaluated and blended in place,
+            /// with a vectorized kernel if the blend mode is one of the built in ones.
+            /// Otherwise the drawable is still read a row at a time and the target is set pixel by pixel.
+            ///
+            /// A clipped target is intersected with the drawable once up front, so nothing outside of it is evaluated
+            /// and a drawable which misses it entirely costs nothing.
             template <typename T> constexpr T& operator()(T& self) const requires SizedPlane<T> and MutablePlane<T> {
-                const auto width = drawable.width();
-                const auto height = drawable.height();
-
-                for (i32 x = 0; x < width; x += 1) {
-                    for (i32 y = 0; y < height; y += 1) {
-                        self.set(
-                            x + this->x, y + this->y,
-                            drawable.get(x, y).blend_over(self.get(x + this->x, y + this->y), blend_mode)
-                        );
+                // The drawn region in the drawable's own coordinates.
+                i32 min_x = 0, min_y = 0;
+                i32 max_x = drawable.width(), max_y = drawable.height();
+
+                if constexpr (ClippedPlane<T>) {
+                    const auto visible = ClipRect { this->x, this->y, max_x, max_y }.intersect(self.clip());
+                    if (visible.empty()) return self;
+
+                    min_x = visible.x - this->x;
+                    min_y = visible.y - this->y;
+                    max_x = min_x + visible.w;
+                    max_y = min_y + visible.h;
+                }
+
+                Color buffer[ROW_CHUNK];
+                [[maybe_unused]] const auto row_blend = kernel::find(blend_mode);
+
+                for (i32 y = min_y; y < max_y; y += 1) {
+                    if constexpr (MutableRowPlane<T>) {
+                        const auto span = self.row_mut(y + this->y, min_x + this->x, max_x + this->x);
+                        for (i32 start = span.begin; start < span.end; start += ROW_CHUNK) {
+                            const i32 count = std::min(ROW_CHUNK, span.end - start);
+                            Color* dst = span.data + (start - span.begin);
+
+                            read_row(drawable, y, start - this->x, start - this->x + count, buffer);
+                            if (row_blend) {
+                                row_blend(buffer, dst, count);
+                            } else {
+                                for (i32 i = 0; i < count; i += 1) {
+                                    dst[i] = buffer[i].blend_over(dst[i], blend_mode);
+                                }
+                            }
+                        }
+                    } else {
+                        for (i32 start = min_x; start < max_x; start += ROW_CHUNK) {
+                            const i32 count = std::min(ROW_CHUNK, max_x - start);
+                            const i32 ty = y + this->y;
+
+                            read_row(drawable, y, start, start + count, buffer);
+                            for (i32 i = 0; i < count; i += 1) {
+                                const i32 tx = start + i + this->x;
+                                if constexpr (UncheckedPlane<T>) {
+                                    self.set_unchecked(tx, ty, buffer[i].blend_over(self.get_unchecked(tx, ty), blend_mode));
+                                } else {
+                                    self.set(tx, ty, buffer[i].blend_over(self.get(tx, ty), blend_mode));
+                                }
+                            }
+                        }
                     }
                 }
 
@@ -362,12 +518,36 @@ namespace draw {
         constexpr void set(i32 x, i32 y, Color color) noexcept(noexcept(inner.set(x, y, color))) requires MutablePlane<T> {
             inner.set(x, y, color);
         }
+
+        constexpr void row(i32 y, i32 x0, i32 x1, Color* out) const requires RowPlane<T> {
+            inner.row(y, x0, x1, out);
+        }
+
+        constexpr auto row_mut(i32 y, i32 x0, i32 x1) -> RowSpan requires MutableRowPlane<T> {
+            return inner.row_mut(y, x0, x1);
+        }
+
+        constexpr auto clip() const noexcept -> ClipRect requires ClippedPlane<T> {
+            return inner.clip();
+        }
+
+        constexpr auto get_unchecked(i32 x, i32 y) const noexcept -> Color requires UncheckedPlane<T> {
+            return inner.get_unchecked(x, y);
+        }
+
+        constexpr void set_unchecked(i32 x, i32 y, Color color) noexcept requires UncheckedPlane<T> {
+            inner.set_unchecked(x, y, color);
+        }
     };
 
+    template <Plane T> class AffinePlane;
+
     template <Plane T> class Slice final {
         T inner;
         i32 x, y, w, h;
 
+        template <Plane U> friend class AffinePlane;
+
       public:
         constexpr explicit Slice(T inner, i32 x, i32 y, i32 width, i32 height) noexcept
             : inner(inner), x(x), y(y), w(width), h(height) {}
@@ -380,6 +560,28 @@ namespace draw {
             inner.set(this->x + x, this->y + y, color);
         }
 
+        constexpr void row(i32 y, i32 x0, i32 x1, Color* out) const requires RowPlane<T> {
+            inner.row(this->y + y, this->x + x0, this->x + x1, out);
+        }
+
+        constexpr auto row_mut(i32 y, i32 x0, i32 x1) -> RowSpan requires MutableRowPlane<T> {
+            const auto span = inner.row_mut(this->y + y, this->x + x0, this->x + x1);
+            return { span.data, span.begin - this->x, span.end - this->x };
+        }
+
+        constexpr auto clip() const noexcept -> ClipRect requires ClippedPlane<T> {
+            const auto inner_clip = inner.clip();
+            return { inner_clip.x - x, inner_clip.y - y, inner_clip.w, inner_clip.h };
+        }
+
+        constexpr auto get_unchecked(i32 x, i32 y) const noexcept -> Color requires UncheckedPlane<T> {
+            return inner.get_unchecked(this->x + x, this->y + y);
+        }
+
+        constexpr void set_unchecked(i32 x, i32 y, Color color) noexcept requires UncheckedPlane<T> {
+            inner.set_unchecked(this->x + x, this->y + y, color);
+        }
+
         constexpr auto width() const noexcept -> i32 {
             return w;
         }
@@ -417,6 +619,59 @@ namespace draw {
         }
     };
 
+    /// Restricts writes to a rectangle of the inner plane, reads are passed through unchanged.
+    /// This is how a part of a target is handed to code which should not touch the rest of it.
+    template <MutablePlane T> class Clip final {
+        T inner;
+        ClipRect rect;
+
+      public:
+        constexpr explicit Clip(T inner, ClipRect rect) noexcept : inner(inner), rect(rect) {}
+
+        constexpr auto width() const noexcept(noexcept(inner.width())) -> i32 requires SizedPlane<T> {
+            return inner.width();
+        }
+
+        constexpr auto height() const noexcept(noexcept(inner.height())) -> i32 requires SizedPlane<T> {
+            return inner.height();
+        }
+
+        constexpr auto get(i32 x, i32 y) const noexcept(noexcept(inner.get(x, y))) -> Color {
+            return inner.get(x, y);
+        }
+
+        constexpr void set(i32 x, i32 y, Color color) noexcept(noexcept(inner.set(x, y, color))) {
+            if (rect.contains(x, y)) inner.set(x, y, color);
+        }
+
+        constexpr void row(i32 y, i32 x0, i32 x1, Color* out) const requires RowPlane<T> {
+            inner.row(y, x0, x1, out);
+        }
+
+        constexpr auto row_mut(i32 y, i32 x0, i32 x1) -> RowSpan requires MutableRowPlane<T> {
+            if (y < rect.y or y >= rect.y + rect.h) return {};
+            const i32 begin = std::max(x0, rect.x), end = std::min(x1, rect.x + rect.w);
+            if (begin >= end) return {};
+            return inner.row_mut(y, begin, end);
+        }
+
+        constexpr auto clip() const noexcept -> ClipRect {
+            if constexpr (ClippedPlane<T>) {
+                return rect.intersect(inner.clip());
+            } else {
+                return rect;
+            }
+        }
+
+        constexpr auto get_unchecked(i32 x, i32 y) const noexcept -> Color requires UncheckedPlane<T> {
+            return inner.get_unchecked(x, y);
+        }
+
+        constexpr void set_unchecked(i32 x, i32 y, Color color) noexcept requires UncheckedPlane<T> {
+            inner.set_unchecked(x, y, color);
+        }
+    };
+
     template <Plane T> struct Grid final {
         T inner;
         i32 item_width, item_height;
@@ -437,6 +692,18 @@ namespace draw {
             template <Plane T> constexpr auto operator()(T inner) const noexcept -> draw::Slice<T> {
                 return draw::Slice<T>(inner, x, y, width, height);
             }
+
+            template <Plane T> constexpr auto operator()(AffinePlane<T> const& inner) const noexcept -> AffinePlane<T> {
+                return inner.slice(x, y, width, height);
+            }
+        };
+
+        struct Clip final {
+            i32 x, y, width, height;
+
+            template <MutablePlane T> constexpr auto operator()(T inner) const noexcept -> draw::Clip<T> {
+                return draw::Clip<T>(inner, ClipRect { x, y, width, height });
+            }
         };
 
         struct Grid final {
@@ -453,6 +720,10 @@ namespace draw {
             template <SizedPlane T> constexpr auto operator()(T inner) const noexcept -> draw::Slice<T> {
                 return draw::Slice<T>(inner, x, y, inner.width(), inner.height());
             }
+
+            template <Plane T> constexpr auto operator()(AffinePlane<T> const& inner) const noexcept -> AffinePlane<T> {
+                return inner.shift(x, y);
+            }
         };
 
         struct AsSlice final {
@@ -485,6 +756,11 @@ namespace draw {
         return adapt::Slice { x, y, width, height };
     }
 
+    /// Restricts writes to an area of a target.
+    constexpr adapt::Clip clip(i32 x, i32 y, i32 width, i32 height) noexcept {
+        return adapt::Clip { x, y, width, height };
+    }
+
     /// Creates a grid which slices out tiles of provided size.
     constexpr adapt::Grid grid(i32 item_width, i32 item_height) noexcept {
         return adapt::Grid { item_width, item_height };
@@ -533,6 +809,13 @@ namespace draw {
         constexpr void set(i32 x, i32 y, Color color) noexcept(noexcept(inner.set(x, y, fn(color, x, y)))) {
             inner.set(x, y, fn(color, x, y));
         }
+
+        constexpr void row(i32 y, i32 x0, i32 x1, Color* out) const requires RowPlane<T> {
+            inner.row(y, x0, x1, out);
+            for (i32 x = x0; x < x1; x += 1) {
+                out[x - x0] = fn(out[x - x0], x, y);
+            }
+        }
     };
 
     template <Plane T, typename F> struct MapPos final {
@@ -625,9 +908,13 @@ namespace draw {
         constexpr auto get(i32 x, i32 y) const noexcept -> Color {
             return color;
         }
+
+        constexpr void row(i32 y, i32 x0, i32 x1, Color* out) const noexcept {
+            std::fill(out, out + (x1 - x0), color);
+        }
     };
 
-    static_assert(SizedPlane<FilledRectangle>);
+    static_assert(SizedPlane<FilledRectangle> and RowPlane<FilledRectangle>);
 }
 
 // Abstract ------------------------------------------------------------------------------------------------------------
@@ -662,6 +949,20 @@ namespace draw {
                 color
             );
         }
+
+        /// A repeated row is made of whole runs of the inner row, so the modulo is only computed once per run.
+        constexpr void row(i32 y, i32 x0, i32 x1, Color* out) const requires RowPlane<T> {
+            const i32 w = width();
+            const i32 wrapped_y = math::arithmetic_mod(y, height());
+
+            i32 x = x0;
+            while (x < x1) {
+                const i32 from = math::arithmetic_mod(x, w);
+                const i32 count = std::min(w - from, x1 - x);
+                inner.row(wrapped_y, from, from + count, out + (x - x0));
+                x += count;
+            }
+        }
     };
 
     namespace adapt {
@@ -729,6 +1030,13 @@ namespace draw {
                 case Case::R: return right.get(x, y);
             }
         }
+
+        constexpr void row(i32 y, i32 x0, i32 x1, Color* out) const requires RowPlane<Left> and RowPlane<Right> {
+            switch (tag) {
+                case Case::L: left.row(y, x0, x1, out); break;
+                case Case::R: right.row(y, x0, x1, out); break;
+            }
+        }
     };
 
     namespace adapt {
@@ -738,11 +1046,17 @@ namespace draw {
 
             constexpr ApplyIf(bool cond, F const& fn) noexcept : cond(cond), fn(fn) {}
 
-            template <Plane T> constexpr auto operator()(T const& inner) const noexcept -> EitherPlane<T, decltype(fn(inner))> {
-                if (not cond) {
-                    return EitherPlane<T, decltype(fn(inner))>(inner);
+            /// When both outcomes can be expressed by the same affine view there is nothing to choose between
+            /// at every pixel, so the result is that view rather than an EitherPlane.
+            template <Plane T> constexpr auto operator()(T const& inner) const noexcept {
+                using Applied = decltype(fn(inner));
+
+                if constexpr (requires { { as_affine(inner) } -> std::same_as<Applied>; }) {
+                    return cond ? fn(inner) : as_affine(inner);
+                } else if (not cond) {
+                    return EitherPlane<T, Applied>(inner);
                 } else {
-                    return EitherPlane<T, decltype(fn(inner))>(fn(inner));
+                    return EitherPlane<T, Applied>(fn(inner));
                 }
             }
         };
@@ -786,6 +1100,45 @@ namespace draw {
                 inner.set(x, height() - 1 - y, color);
             }
         }
+
+        constexpr void row(i32 y, i32 x0, i32 x1, Color* out) const requires RowPlane<T> {
+            if constexpr (AXIS == MirrorAxis::X) {
+                inner.row(y, width() - x1, width() - x0, out);
+                std::reverse(out, out + (x1 - x0));
+            } else {
+                inner.row(height() - 1 - y, x0, x1, out);
+            }
+        }
+
+        /// Only a vertical mirror keeps rows contiguous in the same direction.
+        constexpr auto row_mut(i32 y, i32 x0, i32 x1) -> RowSpan requires MutableRowPlane<T> and (AXIS == MirrorAxis::Y) {
+            return inner.row_mut(height() - 1 - y, x0, x1);
+        }
+
+        constexpr auto clip() const noexcept -> ClipRect requires ClippedPlane<T> {
+            const auto inner_clip = inner.clip();
+            if constexpr (AXIS == MirrorAxis::X) {
+                return { width() - inner_clip.x - inner_clip.w, inner_clip.y, inner_clip.w, inner_clip.h };
+            } else {
+                return { inner_clip.x, height() - inner_clip.y - inner_clip.h, inner_clip.w, inner_clip.h };
+            }
+        }
+
+        constexpr auto get_unchecked(i32 x, i32 y) const noexcept -> Color requires UncheckedPlane<T> {
+            if constexpr (AXIS == MirrorAxis::X) {
+                return inner.get_unchecked(width() - 1 - x, y);
+            } else {
+                return inner.get_unchecked(x, height() - 1 - y);
+            }
+        }
+
+        constexpr void set_unchecked(i32 x, i32 y, Color color) noexcept requires UncheckedPlane<T> {
+            if constexpr (AXIS == MirrorAxis::X) {
+                inner.set_unchecked(width() - 1 - x, y, color);
+            } else {
+                inner.set_unchecked(x, height() - 1 - y, color);
+            }
+        }
     };
 
     template <SizedPlane T> struct RotatedPlane final {
@@ -886,11 +1239,170 @@ namespace draw {
         }
     };
 
+    /// A sized view of a plane through an integer affine transform, the fused form of any chain of
+    /// slices, shifts, mirrors and rotations over it.
+    ///
+    /// The pixel at (x, y) is the inner pixel at (ox + xx * x + xy * y, oy + yx * x + yy * y). However long the chain
+    /// which built it was, a pixel costs one lookup with no branching and a row is walked by adding a constant step,
+    /// or is read from the inner plane directly when it runs along an inner row.
+    ///
+    /// Slicing, shifting, mirroring or rotating a Slice or an AffinePlane produces an AffinePlane, so this is
+    /// what those chains become without having to ask for it.
+    template <Plane T> class AffinePlane final {
+        T inner;
+        i32 ox, oy;
+        i32 xx, xy, yx, yy;
+        i32 w, h;
+
+      public:
+        constexpr AffinePlane(T inner, i32 ox, i32 oy, i32 xx, i32 xy, i32 yx, i32 yy, i32 width, i32 height) noexcept
+            : inner(inner), ox(ox), oy(oy), xx(xx), xy(xy), yx(yx), yy(yy), w(width), h(height) {}
+
+        constexpr explicit AffinePlane(Slice<T> const& slice) noexcept
+            : AffinePlane(slice.inner, slice.x, slice.y, 1, 0, 0, 1, slice.w, slice.h) {}
+
+        constexpr auto width() const noexcept -> i32 {
+            return w;
+        }
+
+        constexpr auto height() const noexcept -> i32 {
+            return h;
+        }
+
+        [[clang::always_inline]]
+        constexpr auto get(i32 x, i32 y) const noexcept(noexcept(inner.get(x, y))) -> Color {
+            return inner.get(ox + xx * x + xy * y, oy + yx * x + yy * y);
+        }
+
+        [[clang::always_inline]]
+        constexpr void set(i32 x, i32 y, Color color) noexcept(noexcept(inner.set(x, y, color))) {
+            inner.set(ox + xx * x + xy * y, oy + yx * x + yy * y, color);
+        }
+
+        /// The matrix is always a signed permutation since it is only ever built from mirrors and quarter turns,
+        /// so its inverse is its transpose and the stored rectangle maps back onto a rectangle.
+        constexpr auto clip() const noexcept -> ClipRect requires ClippedPlane<T> {
+            const auto inner_clip = inner.clip();
+            if (inner_clip.empty()) return {};
+
+            const auto back = [this] (i32 ix, i32 iy) {
+                return std::pair { xx * (ix - ox) + yx * (iy - oy), xy * (ix - ox) + yy * (iy - oy) };
+            };
+            const auto [ax, ay] = back(inner_clip.x, inner_clip.y);
+            const auto [bx, by] = back(inner_clip.x + inner_clip.w - 1, inner_clip.y + inner_clip.h - 1);
+
+            return { std::min(ax, bx), std::min(ay, by), std::abs(bx - ax) + 1, std::abs(by - ay) + 1 };
+        }
+
+        [[clang::always_inline]]
+        constexpr auto get_unchecked(i32 x, i32 y) const noexcept -> Color requires UncheckedPlane<T> {
+            return inner.get_unchecked(ox + xx * x + xy * y, oy + yx * x + yy * y);
+        }
+
+        [[clang::always_inline]]
+        constexpr void set_unchecked(i32 x, i32 y, Color color) noexcept requires UncheckedPlane<T> {
+            inner.set_unchecked(ox + xx * x + xy * y, oy + yx * x + yy * y, color);
+        }
+
+        constexpr void row(i32 y, i32 x0, i32 x1, Color* out) const {
+            const i32 count = x1 - x0;
+            i32 ix = ox + xx * x0 + xy * y;
+            i32 iy = oy + yx * x0 + yy * y;
+
+            if constexpr (RowPlane<T>) {
+                if (yx == 0 and xx == 1) {
+                    inner.row(iy, ix, ix + count, out);
+                    return;
+                }
+                if (yx == 0 and xx == -1) {
+                    inner.row(iy, ix - count + 1, ix + 1, out);
+                    std::reverse(out, out + count);
+                    return;
+                }
+            }
+
+            for (i32 i = 0; i < count; i += 1) {
+                out[i] = inner.get(ix, iy);
+                ix += xx;
+                iy += yx;
+            }
+        }
+
+        /// Views the pixels at (fxx * x + fxy * y + gx, fyx * x + fyy * y + gy) of this plane with a new size.
+        constexpr auto then(i32 fxx, i32 fxy, i32 fyx, i32 fyy, i32 gx, i32 gy, i32 width, i32 height) const noexcept
+            -> AffinePlane
+        {
+            return AffinePlane {
+                inner,
+                ox + xx * gx + xy * gy, oy + yx * gx + yy * gy,
+                xx * fxx + xy * fyx, xx * fxy + xy * fyy,
+                yx * fxx + yy * fyx, yx * fxy + yy * fyy,
+                width, height
+            };
+        }
+
+        constexpr auto slice(i32 x, i32 y, i32 width, i32 height) const noexcept -> AffinePlane {
+            return then(1, 0, 0, 1, x, y, width, height);
+        }
+
+        constexpr auto shift(i32 x, i32 y) const noexcept -> AffinePlane {
+            return then(1, 0, 0, 1, x, y, w, h);
+        }
+
+        template <const MirrorAxis AXIS> constexpr auto mirror() const noexcept -> AffinePlane {
+            if constexpr (AXIS == MirrorAxis::X) {
+                return then(-1, 0, 0, 1, w - 1, 0, w, h);
+            } else {
+                return then(1, 0, 0, -1, 0, h - 1, w, h);
+            }
+        }
+
+        /// Matches RotatedPlane.
+        constexpr auto rotate(i32 step) const noexcept -> AffinePlane {
+            switch (math::arithmetic_mod(step, 4)) {
+                case 0: return *this;
+                case 1: return then(0, -1, 1, 0, w - 1, 0, h, w);
+                case 2: return then(-1, 0, 0, -1, w - 1, h - 1, w, h);
+                case 3: return then(0, 1, -1, 0, 0, h - 1, h, w);
+            }
+            std::unreachable();
+        }
+
+        /// Matches RotatedGlobalPlane.
+        constexpr auto rotate_global(i32 step) const noexcept -> AffinePlane {
+            switch (math::arithmetic_mod(step, 4)) {
+                case 0: return *this;
+                case 1: return then(0, 1, -1, 0, 0, 0, w, h);
+                case 2: return then(-1, 0, 0, -1, 0, 0, w, h);
+                case 3: return then(0, -1, 1, 0, 0, 0, w, h);
+            }
+            std::unreachable();
+        }
+    };
+
+    /// The affine view of a plane which already is one or trivially becomes one.
+    /// This is how adapters know they can fuse rather than wrap.
+    template <Plane T> constexpr auto as_affine(Slice<T> const& slice) noexcept -> AffinePlane<T> {
+        return AffinePlane<T>(slice);
+    }
+
+    template <Plane T> constexpr auto as_affine(AffinePlane<T> const& plane) noexcept -> AffinePlane<T> {
+        return plane;
+    }
+
     namespace adapt {
         template <const MirrorAxis AXIS> struct Mirror final {
             template <SizedPlane T> constexpr auto operator()(T inner) const noexcept -> MirroredPlane<AXIS, T> {
                 return MirroredPlane<AXIS, T>(inner);
             }
+
+            template <Plane T> constexpr auto operator()(draw::Slice<T> const& inner) const noexcept -> AffinePlane<T> {
+                return as_affine(inner).template mirror<AXIS>();
+            }
+
+            template <Plane T> constexpr auto operator()(AffinePlane<T> const& inner) const noexcept -> AffinePlane<T> {
+                return inner.template mirror<AXIS>();
+            }
         };
 
         struct Rotate final {
@@ -899,6 +1411,14 @@ namespace draw {
             template <SizedPlane T> constexpr auto operator()(T inner) const noexcept -> RotatedPlane<T> {
                 return RotatedPlane<T>(inner, rotation_step);
             }
+
+            template <Plane T> constexpr auto operator()(draw::Slice<T> const& inner) const noexcept -> AffinePlane<T> {
+                return as_affine(inner).rotate(rotation_step);
+            }
+
+            template <Plane T> constexpr auto operator()(AffinePlane<T> const& inner) const noexcept -> AffinePlane<T> {
+                return inner.rotate(rotation_step);
+            }
         };
 
         struct RotateGlobal final {
@@ -907,6 +1427,28 @@ namespace draw {
             template <SizedPlane T> constexpr auto operator()(T inner) const noexcept -> RotatedGlobalPlane<T> {
                 return RotatedGlobalPlane<T>(inner, rotation_step);
             }
+
+            template <Plane T> constexpr auto operator()(draw::Slice<T> const& inner) const noexcept -> AffinePlane<T> {
+                return as_affine(inner).rotate_global(rotation_step);
+            }
+
+            template <Plane T> constexpr auto operator()(AffinePlane<T> const& inner) const noexcept -> AffinePlane<T> {
+                return inner.rotate_global(rotation_step);
+            }
+        };
+
+        struct Affine final {
+            template <SizedPlane T> constexpr auto operator()(T inner) const noexcept -> AffinePlane<T> {
+                return AffinePlane<T>(inner, 0, 0, 1, 0, 0, 1, inner.width(), inner.height());
+            }
+
+            template <Plane T> constexpr auto operator()(draw::Slice<T> const& inner) const noexcept -> AffinePlane<T> {
+                return as_affine(inner);
+            }
+
+            template <Plane T> constexpr auto operator()(AffinePlane<T> const& inner) const noexcept -> AffinePlane<T> {
+                return inner;
+            }
         };
     }
 
@@ -929,4 +1471,10 @@ namespace draw {
     constexpr adapt::RotateGlobal rotate_global(i32 step) noexcept {
         return adapt::RotateGlobal { step };
     }
+
+    /// Explicitly views a sized drawable through an affine transform, starting out as the identity.
+    /// Slices and the layout adapters already do this on their own when applied to a slice.
+    constexpr adapt::Affine affine() noexcept {
+        return adapt::Affine {};
+    }
 }
@@ -0,0 +1,96 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines a persistent view of a layer which only ever changes by scrolling.
+#pragma once
+#include <primitive>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "color.hpp"
+#include "image.hpp"
+
+namespace draw {
+    /// Keeps the pixels of a view into a large unchanging layer between frames.
+    ///
+    /// When the view moves the pixels still visible are moved along with it a row at a time and
+    /// only the strips that scrolled into view are drawn again. A camera moving a few pixels a frame
+    /// therefore redraws a few thin strips rather than the whole screen.
+    ///
+    /// The layer only holds what it was asked to draw, whatever goes on top of it (like objects) is drawn into
+    /// the frame it is composed into, so nothing on top ever has to be repaired here.
+    class ScrollLayer final {
+        Image image;
+        i32 x { 0 }, y { 0 };
+        bool valid { false };
+
+        template <typename F> void expose(i32 x, i32 y, i32 width, i32 height, F& redraw) {
+            if (width <= 0 or height <= 0) return;
+
+            for (i32 row = y; row < y + height; row += 1) {
+                const auto start = image.raw() + x + row * image.width();
+                std::fill(start, start + width, color::CLEAR);
+            }
+            redraw(image, x, y, width, height);
+        }
+
+      public:
+        /// The pixels of the current view, the top left one being at the last scrolled to position in the layer.
+        auto pixels() const noexcept -> Image const& {
+            return image;
+        }
+
+        /// Forgets the current pixels, the next scroll will draw the entire view again.
+        void invalidate() noexcept {
+            valid = false;
+        }
+
+        /// Moves the view to a position in the layer, drawing whatever was not already visible with the provided
+        /// function of signature:
+        /// (Image& view, i32 x, i32 y, i32 width, i32 height) -> void
+        ///
+        /// The rectangle is in the coordinates of the view and starts out clear, the function must draw
+        /// the layer within it and should avoid drawing outside of it since that is wasted work.
+        template <typename F> void scroll(i32 x, i32 y, i32 width, i32 height, F redraw) {
+            const i32 dx = x - this->x;
+            const i32 dy = y - this->y;
+            this->x = x;
+            this->y = y;
+
+            if (width != image.width() or height != image.height()) {
+                image = Image(width, height);
+                valid = false;
+            }
+
+            if (not valid or std::abs(dx) >= width or std::abs(dy) >= height) {
+                valid = true;
+                expose(0, 0, width, height, redraw);
+                return;
+            }
+            if (dx == 0 and dy == 0) return;
+
+            // Rows from `first` up to `last` keep pixels, which within a row are `count` pixels starting at `into`.
+            const i32 first = std::max(-dy, 0);
+            const i32 last = height - std::max(dy, 0);
+            const i32 from = std::max(dx, 0);
+            const i32 into = std::max(-dx, 0);
+            const i32 count = width - std::abs(dx);
+
+            // Rows are moved in the direction that never overwrites a source row before it was read.
+            const auto data = image.raw();
+            const auto move = [=] (i32 row) {
+                std::memmove(data + into + row * width, data + from + (row + dy) * width, usize(count) * sizeof(Color));
+            };
+            if (dy > 0) {
+                for (i32 row = first; row < last; row += 1) move(row);
+            } else {
+                for (i32 row = last - 1; row >= first; row -= 1) move(row);
+            }
+
+            expose(0, 0, width, first, redraw);
+            expose(0, last, width, height - last, redraw);
+            expose(0, first, into, last - first, redraw);
+            expose(into + count, first, width - into - count, last - first, redraw);
+        }
+    };
+}
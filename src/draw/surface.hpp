@@ -0,0 +1,99 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines a view of pixels stored elsewhere, like the memory of a locked texture.
+#pragma once
+#include <primitive>
+#include <algorithm>
+#include "plane.hpp"
+#include "image.hpp"
+
+namespace draw {
+    /// A sized, mutable view of pixels the view does not own, with rows which need not be next to each other.
+    ///
+    /// This is how something other than an image is drawn into directly, most importantly the memory a graphics API
+    /// hands out for a texture, which is laid out with a pitch of its own choosing. It behaves just like an image
+    /// of the same size, reading clear outside of it, and like a Ref it is cheap to pass around by value.
+    class Surface final {
+        Color* data;
+        i32 w, h;
+        /// The distance from the start of one row to the start of the next, in pixels.
+        i32 pitch;
+
+      public:
+        constexpr Surface(Color* data, i32 width, i32 height, i32 pitch) noexcept
+            : data(data), w(width), h(height), pitch(pitch) {}
+
+        /// Views the whole of an image.
+        Surface(Image& image) noexcept : Surface(image.raw(), image.width(), image.height(), image.width()) {}
+
+        auto width() const noexcept -> i32 {
+            return w;
+        }
+
+        auto height() const noexcept -> i32 {
+            return h;
+        }
+
+        auto get(i32 x, i32 y) const noexcept -> Color {
+            if (x >= 0 and x < w and y >= 0 and y < h) {
+                return data[x + y * pitch];
+            } else {
+                return color::CLEAR;
+            }
+        }
+
+        void set(i32 x, i32 y, Color color) noexcept {
+            if (x >= 0 and x < w and y >= 0 and y < h) {
+                data[x + y * pitch] = color;
+            }
+        }
+
+        auto clip() const noexcept -> ClipRect {
+            return { 0, 0, w, h };
+        }
+
+        /// Only valid within `clip()`.
+        [[clang::always_inline]] auto get_unchecked(i32 x, i32 y) const noexcept -> Color {
+            return data[x + y * pitch];
+        }
+
+        /// Only valid within `clip()`.
+        [[clang::always_inline]] void set_unchecked(i32 x, i32 y, Color color) noexcept {
+            data[x + y * pitch] = color;
+        }
+
+        void row(i32 y, i32 x0, i32 x1, Color* out) const noexcept {
+            if (y < 0 or y >= h) {
+                std::fill(out, out + (x1 - x0), color::CLEAR);
+                return;
+            }
+
+            // The stored pixels are the ones from `lo` up to `hi` in the output.
+            const i32 count = x1 - x0;
+            const i32 lo = std::clamp(-x0, 0, count);
+            const i32 hi = std::clamp(w - x0, lo, count);
+            std::fill(out, out + lo, color::CLEAR);
+            if (lo < hi) {
+                // Only formed once it is known to point into the row, `x0` alone may lie before the image.
+                const auto source = data + y * pitch + x0 + lo;
+                std::copy(source, source + (hi - lo), out + lo);
+            }
+            std::fill(out + hi, out + count, color::CLEAR);
+        }
+
+        auto row_mut(i32 y, i32 x0, i32 x1) noexcept -> RowSpan {
+            if (y < 0 or y >= h) return {};
+
+            const i32 begin = std::max(x0, 0);
+            const i32 end = std::min(x1, w);
+            if (begin >= end) return {};
+            return { data + begin + y * pitch, begin, end };
+        }
+    };
+
+    // Assert that our type properly satisfies the desired interface.
+    static_assert(SizedPlane<Surface> and MutablePlane<Surface>);
+    static_assert(RowPlane<Surface> and MutableRowPlane<Surface>);
+    static_assert(ClippedPlane<Surface> and UncheckedPlane<Surface>);
+}
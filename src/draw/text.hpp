@@ -124,9 +124,14 @@ namespace draw {
             if (not cache) cache = redraw();
             return cache->get(x, y);
         }
+
+        void row(i32 y, i32 x0, i32 x1, Color* out) const {
+            if (not cache) cache = redraw();
+            cache->row(y, x0, x1, out);
+        }
     };
 
     template <typename T> Text(char const*, Font<T, char>, Color = color::WHITE) -> Text<T, std::string_view>;
 
-    static_assert(SizedPlane<Text<Image>>);
+    static_assert(SizedPlane<Text<Image>> and RowPlane<Text<Image>>);
 }
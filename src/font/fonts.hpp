@@ -3,6 +3,8 @@
 #pragma once
 #include <draw>
 #include <io>
+#include <mutex>
+#include <unordered_map>
 
 namespace font {
     using draw::Font;
@@ -485,4 +487,15 @@ namespace font {
 
         return font;
     }
+
+    /// The glyph atlas of one of the fonts above, resolved the first time it is asked for.
+    inline auto glyphs(Font<Ref<const Image>, char> const& font) -> draw::GlyphAtlas const& {
+        static std::mutex lock;
+        static std::unordered_map<void const*, draw::GlyphAtlas> atlases;
+
+        std::lock_guard guard(lock);
+        auto [it, inserted] = atlases.try_emplace(&font);
+        if (inserted) it->second = draw::GlyphAtlas::of(font);
+        return it->second;
+    }
 }
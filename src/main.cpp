@@ -6,6 +6,7 @@
 #include <sonic>
 
 using draw::Image;
+using draw::IndexedImage;
 using draw::TgaImage;
 
 static std::atomic<bool> RELOAD_REQUESTED = false;
@@ -18,21 +19,22 @@ void reload_handler(i32 signal) {
 #endif
 
 class SonicGame final {
-    Image sheet;
+    IndexedImage sheet;
     Image height_arrays;
     Image angle_sheet;
-    Image background;
+    IndexedImage background;
     Box<sonic::Scene> scene;
 
   public:
     SonicGame() {}
 
     void init(Io& io) {
-        sheet         = TgaImage::from(io.read_file("res/tilemap.tga")) | draw::flatten<Image>();
+        // The art of the original hardware is all indexed so these fit and take a quarter of the memory.
+        sheet         = IndexedImage::from(TgaImage::from(io.read_file("res/tilemap.tga"))).value();
         height_arrays = TgaImage::from(io.read_file("res/collision.tga")) | draw::flatten<Image>();
         angle_sheet   = TgaImage::from(io.read_file("res/angles.tga")) | draw::flatten<Image>();
-        background    = TgaImage::from(io.read_file("res/background.tga")) | draw::flatten<Image>();
-        scene = sonic::Stage::load(io, "res/1-1.stage", height_arrays);
+        background    = IndexedImage::from(TgaImage::from(io.read_file("res/background.tga"))).value();
+        scene = sonic::Stage::load(io, "res/1-1.stage", sheet, height_arrays, background);
     }
 
     void update(Io& io, rt::Input const& input) {
@@ -43,9 +45,25 @@ class SonicGame final {
         scene->update(io, input);
     }
 
-    void draw(Io& io, rt::Input const& input, draw::Ref<draw::Image> target) const {
+    void draw(Io& io, rt::Input const& input, draw::Surface target) const {
         scene->draw(io, input, target, sheet, background);
     }
+
+    // The runtime draws a tick while simulating the next one through these.
+
+    using Snapshot = sonic::Snapshot;
+
+    void snapshot(rt::Input const& input, i32 width, i32 height, Snapshot& out) const {
+        scene->snapshot(input, width, height, out);
+    }
+
+    void render(Io& io, Snapshot const& snapshot, fixed alpha, draw::Surface target) const {
+        scene->render(io, snapshot, alpha, target, sheet, background);
+    }
+
+    void overlay(Io& io, Snapshot const& snapshot, fixed alpha, draw::Surface target) const {
+        scene->overlay(io, snapshot, alpha, target);
+    }
 };
 
 auto main() -> i32 {
@@ -0,0 +1,137 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines a fixed capacity string builder for formatting numbers without allocating.
+#pragma once
+#include "primitive.hpp"
+#include "fixed.hpp"
+#include <charconv>
+#include <algorithm>
+#include <concepts>
+#include <string_view>
+
+/// A value written at least `width` characters wide, filled from the left.
+template <typename T> struct Padded final {
+    T value;
+    i32 width;
+    char fill;
+};
+
+/// Pads a value to a width when written to a FixedString, like std::setw and std::setfill do for streams.
+template <typename T> constexpr auto pad(T value, i32 width, char fill = ' ') noexcept -> Padded<T> {
+    return Padded<T> { value, width, fill };
+}
+
+/// A string of at most N characters stored inline, written to much like a stream.
+///
+/// Numbers are formatted with std::to_chars, so there is no locale and nothing is ever allocated,
+/// which makes it fit for text redrawn every frame. Anything written past the capacity is dropped.
+template <usize N> class FixedString final {
+    char storage[N];
+    usize length { 0 };
+
+  public:
+    constexpr FixedString() noexcept = default;
+
+    constexpr FixedString(std::string_view text) noexcept {
+        append(text);
+    }
+
+    constexpr void clear() noexcept {
+        length = 0;
+    }
+
+    constexpr auto size() const noexcept -> usize {
+        return length;
+    }
+
+    static constexpr auto capacity() noexcept -> usize {
+        return N;
+    }
+
+    constexpr auto view() const noexcept -> std::string_view {
+        return std::string_view(storage, length);
+    }
+
+    constexpr operator std::string_view() const noexcept {
+        return view();
+    }
+
+    constexpr void append(std::string_view text) noexcept {
+        const usize count = std::min(text.size(), N - length);
+        for (usize i = 0; i < count; i += 1) storage[length + i] = text[i];
+        length += count;
+    }
+
+    constexpr void append(char c, usize count = 1) noexcept {
+        for (usize i = 0; i < count and length < N; i += 1) storage[length++] = c;
+    }
+
+    /// Calls the provided function for every line, the same lines std::getline would read, with signature:
+    /// (std::string_view line) -> void
+    template <typename F> void each_line(F fn) const {
+        auto rest = view();
+        while (not rest.empty()) {
+            const auto end = rest.find('\n');
+            fn(rest.substr(0, end));
+            if (end == std::string_view::npos) break;
+            rest.remove_prefix(end + 1);
+        }
+    }
+
+    auto operator<<(std::string_view text) noexcept -> FixedString& {
+        append(text);
+        return *this;
+    }
+
+    auto operator<<(char const* text) noexcept -> FixedString& {
+        append(std::string_view(text));
+        return *this;
+    }
+
+    auto operator<<(char c) noexcept -> FixedString& {
+        append(c);
+        return *this;
+    }
+
+    /// Integers are always written as numbers, including the character sized ones streams write as characters.
+    template <std::integral T> requires (not std::same_as<T, char> and not std::same_as<T, bool>)
+    auto operator<<(T value) noexcept -> FixedString& {
+        return *this << pad(value, 0);
+    }
+
+    /// Written in the shortest form, like a stream with the default precision.
+    auto operator<<(f64 value) noexcept -> FixedString& {
+        return *this << pad(value, 0);
+    }
+
+    /// Written as the whole part and the raw fraction out of 256, like the stream operator of fixed.
+    auto operator<<(fixed value) noexcept -> FixedString& {
+        return *this << pad(value, 0);
+    }
+
+    template <typename T> auto operator<<(Padded<T> padded) noexcept -> FixedString& {
+        char digits[32];
+        auto end = digits;
+
+        if constexpr (std::same_as<T, fixed>) {
+            const i32 whole = i32(padded.value);
+            const u8 fraction = whole > 0 ? u8(fixed::into_raw(padded.value) & 0xFF) : u8(256 - (fixed::into_raw(padded.value) & 0xFF));
+
+            end = std::to_chars(end, digits + sizeof(digits), whole).ptr;
+            *end++ = '.';
+            if (fraction < 100) *end++ = '0';
+            if (fraction < 10) *end++ = '0';
+            end = std::to_chars(end, digits + sizeof(digits), u32(fraction)).ptr;
+        } else if constexpr (std::floating_point<T>) {
+            end = std::to_chars(end, digits + sizeof(digits), padded.value, std::chars_format::general, 6).ptr;
+        } else {
+            end = std::to_chars(end, digits + sizeof(digits), padded.value).ptr;
+        }
+
+        const auto written = usize(end - digits);
+        if (padded.width > 0 and usize(padded.width) > written) append(padded.fill, usize(padded.width) - written);
+        append(std::string_view(digits, written));
+        return *this;
+    }
+};
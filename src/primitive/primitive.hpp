@@ -96,6 +96,12 @@ namespace math {
         static_assert(std::is_integral<T>::value and std::is_signed<T>::value);
         return (a % b + b) % b;
     }
+
+    /// Division rounding towards negative infinity, the counterpart of the arithmetic modulo.
+    template <typename T> constexpr auto floor_div(T a, T b) noexcept -> T {
+        static_assert(std::is_integral<T>::value and std::is_signed<T>::value);
+        return (a - arithmetic_mod(a, b)) / b;
+    }
 }
 
 /// Some compilers are weird and compare this differently which breaks across shared libraries.
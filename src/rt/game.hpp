@@ -9,13 +9,15 @@
 #include <draw>
 #include <font>
 #include <io>
-#include <sstream>
 #include <string>
 #include <optional>
 #include <atomic>
+#include <memory>
+#include <type_traits>
 #include <unordered_set>
 #include <iostream>
 #include <chrono>
+#include <algorithm>
 #include <numeric>
 #include <SDL3/SDL.h>
 
@@ -365,6 +367,7 @@ namespace rt {
             Hz90  = 90,
             Hz120 = 120,
             Hz144 = 144,
+            Hz165 = 165,
             Hz240 = 240,
             Hz360 = 360,
         };
@@ -388,7 +391,7 @@ namespace rt {
                 / (f64) acc.size();
 
             const auto common_rates = {
-                Hz30, Hz60, Hz75, Hz90, Hz120, Hz144, Hz240, Hz360,
+                Hz30, Hz60, Hz75, Hz90, Hz120, Hz144, Hz165, Hz240, Hz360,
             };
 
             estimated_millis = average;
@@ -402,6 +405,12 @@ namespace rt {
             }
         }
 
+        /// How long a frame takes, exactly the period of the display once its rate is recognized
+        /// so that jitter in the timestamps does not disturb what is paced by it.
+        auto frame_millis() const -> f64 {
+            return common_rate ? 1000.0 / (f64) (u32) *common_rate : acc.front();
+        }
+
         auto compatible_with_tick(u32 tick) const -> bool {
             return estimated_hertz % tick == 0;
         }
@@ -434,6 +443,48 @@ namespace rt {
         return HeuristicTimestampBasedRefreshRateLock {};
     }
 
+    /// Paces ticks of a fixed rate by the frames of a display of any rate, so that the simulation stays exactly
+    /// the same while frames in between ticks are drawn partway from one tick to the next.
+    ///
+    /// Time is accumulated a frame at a time and taken out a whole tick at a time. What is left is how far
+    /// past the tick before the latest one the frame is. Ticks are simulated while the previous one is drawn,
+    /// so a frame runs the ticks the next frame is going to need, assuming it takes as long.
+    ///
+    /// Time starts on a tick, so on displays of a multiple of the tick rate frames keep landing exactly on ticks
+    /// and those frames are drawn with an alpha of one, the same as without any interpolation.
+    class FixedTimestep final {
+        f64 tick_millis;
+        f64 accumulated { 0 };
+
+        /// How far off a tick, as a part of one, a frame may be and still count as landing on it,
+        /// so that rounding in the accumulated time does not tip the count of ticks back and forth.
+        static constexpr f64 EPSILON = 1.0 / 1024.0;
+
+      public:
+        /// After a stall at most this many ticks are caught up on at once, the rest of the time is dropped.
+        static constexpr u32 MAX_TICKS = 4;
+
+        struct Step final {
+            /// How many ticks to run during this frame.
+            u32 ticks;
+            /// How far between the tick before the latest one and the latest one this frame is, up to one.
+            fixed alpha;
+        };
+
+        explicit FixedTimestep(u32 rate) : tick_millis(1000.0 / (f64) rate) {}
+
+        /// Adds a frame which takes the given time.
+        auto advance(f64 frame_millis) -> Step {
+            accumulated += frame_millis;
+
+            const f64 progress = std::clamp(accumulated / tick_millis + EPSILON, 0.0, 1.0);
+            const u32 ticks = std::min(u32(std::max((accumulated + frame_millis) / tick_millis - EPSILON, 0.0)), MAX_TICKS);
+            accumulated = std::min(accumulated - ticks * tick_millis, tick_millis - frame_millis);
+
+            return Step { ticks, fixed::from_raw(i32(progress * 256.0)) };
+        }
+    };
+
     /// Defines a game runnable by a game executor. The default is `run(game)`.
     ///
     /// This does not use virtual dispatch because that would require the draw method
@@ -444,13 +495,32 @@ namespace rt {
     /// The catch is, without C++20 modules, this means the run implementation must be a template,
     /// so it is impossible for it to avoid exposing SDL includes, but that's an arbitrary
     /// issue caused by being forced to support old C++.
+    ///
+    /// Frames are drawn straight into the memory of the texture they are presented from, which holds
+    /// whatever it did before, so drawing a frame has to cover every pixel of the target.
     template <typename Self>
-    concept Game = requires(Self const& self, Self& self_mut, draw::Ref<draw::Image> target, Io& io, Input const& input) {
+    concept Game = requires(Self const& self, Self& self_mut, draw::Surface target, Io& io, Input const& input) {
         { self_mut.init(io) } -> std::same_as<void>;
         { self_mut.update(io, input) } -> std::same_as<void>;
         { self.draw(io, input, target) } -> std::same_as<void>;
     };
 
+    /// A game which can also draw a tick from a snapshot of it, so that the executor can draw one tick
+    /// on another thread while the next one is simulated.
+    ///
+    /// `render` must only read the snapshot and whatever `update` never changes. `overlay` is drawn on top
+    /// once both are done and may look at anything. Both are given how far between the tick before the snapshot
+    /// and the snapshot itself the frame is, so that displays faster than the ticks see smooth motion.
+    template <typename Self>
+    concept PipelinedGame = Game<Self> and requires(
+        Self const& self, draw::Surface target, Io& io, Input const& input, fixed alpha,
+        typename Self::Snapshot& snapshot, typename Self::Snapshot const& snapshot_ref
+    ) {
+        { self.snapshot(input, target.width(), target.height(), snapshot) } -> std::same_as<void>;
+        { self.render(io, snapshot_ref, alpha, target) } -> std::same_as<void>;
+        { self.overlay(io, snapshot_ref, alpha, target) } -> std::same_as<void>;
+    };
+
     /// An error raised while running the game using the default executor.
     struct RunError final {
         /// The cause of the error.
@@ -468,12 +538,20 @@ namespace rt {
         std::optional<std::string> description { std::nullopt };
     };
 
+    /// The state the executor keeps for running a pipelined game.
+    template <typename Snapshot> struct Pipeline final {
+        /// Draws the previous tick while the next one is simulated.
+        Worker renderer;
+        DoubleBuffer<Snapshot> snapshots;
+    };
+
     /// Runs a game in the environment.
     ///
     /// This method was moved from Game into an environment message.
     /// A game cannot run itself, it is run by the platform it's on
     /// and can be run in many ways, this is just one implementation.
     static void run(Game auto& game, char const* title, i32 scale, i32 width, i32 height) {
+        using G = std::remove_cvref_t<decltype(game)>;
         static std::atomic<bool> is_running = false;
 
         if (is_running.load()) {
@@ -558,9 +636,23 @@ namespace rt {
         usize frame = 0;
         bool perf_overlay = false;
         bool heuristic_rate_lock = true;
-        auto target = draw::Image(width / scale, height / scale);
+        i32 target_width = width / scale, target_height = height / scale;
+        // Frames are drawn straight into the memory of the locked texture, which saves copying every frame over.
+        // Should a texture not lock into memory we can draw into, frames are drawn here and copied over instead.
+        bool locked_present = true;
+        auto fallback = draw::Image();
+        // Changing the scale reallocates the texture, which has to wait until it is no longer locked.
+        bool rescale = false;
         auto input = rt::input();
         auto rate = rt::refresh_rate_lock();
+        auto timestep = FixedTimestep(60);
+
+        // Pipelined games draw the previous tick on a second thread while the next one is simulated,
+        // so a tick takes as long as the slower of the two rather than both added together.
+        // The frame presented is then always one tick behind the simulation.
+        [[maybe_unused]] auto pipeline = [] {
+            if constexpr (PipelinedGame<G>) return std::make_unique<Pipeline<typename G::Snapshot>>(); else return nullptr;
+        }();
 
         const auto apply_window_size = [&] {
             // We are explicitly using the scaled window size and not the
@@ -569,8 +661,35 @@ namespace rt {
             // Effectively the game is always scaled twice on high density displays which will
             // give consistent sizing between devices.
             i32 w, h; SDL_GetWindowSize(window, &w, &h);
-            resize_texture(w / scale, h / scale);
-            target.resize(w / scale, h / scale);
+            target_width = w / scale;
+            target_height = h / scale;
+            resize_texture(target_width, target_height);
+        };
+
+        /// Draws a frame into the texture with the provided function, with signature:
+        /// (draw::Surface target) -> void
+        /// The target holds whatever was left in its memory, so the function has to draw every pixel.
+        const auto draw_frame = [&] (auto fn) {
+            if (locked_present) {
+                void* pixels; i32 pitch;
+                if (SDL_LockTexture(texture, nullptr, &pixels, &pitch)) {
+                    const bool whole_pixels = pitch % i32(sizeof(draw::Color)) == 0;
+                    if (whole_pixels) {
+                        fn(draw::Surface(
+                            static_cast<draw::Color*>(pixels), target_width, target_height, pitch / i32(sizeof(draw::Color))
+                        ));
+                    }
+                    SDL_UnlockTexture(texture);
+                    if (whole_pixels) return;
+                }
+                locked_present = false;
+            }
+
+            if (fallback.width() != target_width or fallback.height() != target_height) {
+                fallback = draw::Image(target_width, target_height);
+            }
+            fn(draw::Surface(fallback));
+            SDL_UpdateTexture(texture, nullptr, fallback.raw(), i32(fallback.width() * sizeof(draw::Color)));
         };
 
         while (true) {
@@ -581,68 +700,105 @@ namespace rt {
                     default: break;
                 }
             }
+            if (rescale) {
+                apply_window_size();
+                rescale = false;
+            }
 
             // Ensure stable 60hz.
             rate.lap();
 
-            const auto draw_perf_overlay = [&] {
-                std::stringstream out;
+            const auto draw_perf_overlay = [&] (draw::Surface target) {
+                FixedString<512> out;
                 out << "Assumed rate: ";
-                if (rate.common_rate) out << *rate.common_rate; else out << "Unknown";
-                out << std::endl
-                    << "Estimated rate: " << rate.estimated_hertz << std::endl
-                    << "Average ms: " << rate.estimated_millis << std::endl
-                    << "Vsync status: " << (is_vsync ? "Enabled" : "Disabled") << std::endl
-                    << "Heuristic lock status: " << (heuristic_rate_lock ? "Enabled" : "Disabled") << std::endl
-                    << "Scale: " << scale << "x" << std::endl;
-
-                std::string line;
-                std::vector<std::pair<draw::Text<draw::Ref<const draw::Image>, std::string>, i32>> lines;
-                for (i32 y = 8; std::getline(out, line); y += font::mine(io).height + font::mine(io).leading) {
-                    lines.emplace_back(draw::Text(line, font::mine(io)), y);
-                }
+                if (rate.common_rate) out << u32(*rate.common_rate); else out << "Unknown";
+                out << '\n'
+                    << "Estimated rate: " << rate.estimated_hertz << '\n'
+                    << "Average ms: " << rate.estimated_millis << '\n'
+                    << "Vsync status: " << (is_vsync ? "Enabled" : "Disabled") << '\n'
+                    << "Heuristic lock status: " << (heuristic_rate_lock ? "Enabled" : "Disabled") << '\n'
+                    << "Scale: " << scale << "x" << '\n'
+                    << "Blend kernels: " << draw::kernel::active().name << '\n'
+                    << "Present: " << (locked_present ? "Locked texture" : "Copied") << '\n';
+
+                auto const& glyphs = font::glyphs(font::mine(io));
 
                 i32 greatest_width = 0;
-                for (auto const& [text, y] : lines) if (text.width() > greatest_width) greatest_width = text.width();
-                for (auto const& [text, y] : lines) target | draw::draw(text, target.width() - 8 - greatest_width, y);
+                out.each_line([&] (std::string_view line) {
+                    if (glyphs.width(line) > greatest_width) greatest_width = glyphs.width(line);
+                });
+
+                i32 y = 8;
+                out.each_line([&] (std::string_view line) {
+                    target | draw::write(glyphs, line, target.width() - 8 - greatest_width, y);
+                    y += font::mine(io).height + font::mine(io).leading;
+                });
             };
 
-            const bool could_sync = rate.sync(frame, heuristic_rate_lock ? 60 : 0, [&]{
-                input.poll();
+            const auto process_debug_keys = [&] {
+                if (input.key_pressed(Key::Num0)) {
+                    is_vsync = !is_vsync;
+                    SDL_SetRenderVSync(renderer, is_vsync);
+                }
+                if (input.key_pressed(Key::Num8)) heuristic_rate_lock = !heuristic_rate_lock;
+                if (input.key_pressed(Key::Num9)) perf_overlay = !perf_overlay;
 
-                { // Process runtime specific debug options.
-                    if (input.key_pressed(Key::Num0)) {
-                        is_vsync = !is_vsync;
-                        SDL_SetRenderVSync(renderer, is_vsync);
+                if (bool p = input.key_pressed(Key::Plus), m = input.key_pressed(Key::Minus); p or m) {
+                    if (p) scale = std::min(8, scale + 1);
+                    if (m) scale = std::max(1, scale - 1);
+                    rescale = true;
+                }
+
+                #ifdef _MSC_VER // Fullscreen button for a funny operating system.
+                if (input.key_pressed(Key::F1)) SDL_SetWindowFullscreen(window, true);
+                #endif
+            };
+
+            if constexpr (PipelinedGame<G>) {
+                // Ticks are paced by the clock and every frame is drawn, partway between ticks on displays faster than them.
+                // Without the lock every frame is a whole tick.
+                const auto step = heuristic_rate_lock ? timestep.advance(rate.frame_millis()) : FixedTimestep::Step { 1, 1 };
+
+                draw_frame([&] (draw::Surface target) {
+                    const auto previous = pipeline->snapshots.front();
+                    const auto render = [&] { game.render(io, *previous, step.alpha, target); };
+                    if (previous) pipeline->renderer.start(render); else target | draw::clear(draw::color::BLACK);
+
+                    for (u32 i = 0; i < step.ticks; i += 1) {
+                        input.poll();
+                        process_debug_keys();
+                        game.update(io, input);
                     }
-                    if (input.key_pressed(Key::Num8)) heuristic_rate_lock = !heuristic_rate_lock;
-                    if (input.key_pressed(Key::Num9)) perf_overlay = !perf_overlay;
+                    if (step.ticks > 0) game.snapshot(input, target.width(), target.height(), pipeline->snapshots.back());
 
-                    if (bool p = input.key_pressed(Key::Plus), m = input.key_pressed(Key::Minus); p or m) {
-                        if (p) scale = std::min(8, scale + 1);
-                        if (m) scale = std::max(1, scale - 1);
-                        apply_window_size();
+                    if (previous) {
+                        pipeline->renderer.wait();
+                        game.overlay(io, *previous, step.alpha, target);
                     }
+                    if (step.ticks > 0) pipeline->snapshots.publish();
 
-                    #ifdef _MSC_VER // Fullscreen button for a funny operating system.
-                    if (input.key_pressed(Key::F1)) SDL_SetWindowFullscreen(window, true);
-                    #endif
+                    if (perf_overlay) draw_perf_overlay(target);
+                });
+            } else {
+                // Frames skipped by the lock present the texture as it was.
+                const bool could_sync = rate.sync(frame, heuristic_rate_lock ? 60 : 0, [&]{
+                    input.poll();
+                    process_debug_keys();
+
+                    game.update(io, input);
+                    draw_frame([&] (draw::Surface target) {
+                        game.draw(io, input, target);
+                        if (perf_overlay) draw_perf_overlay(target);
+                    });
+                });
+                if (not could_sync) {
+                    // TODO: Show diagnostic message in the corner or something instead.
+                    std::cerr << "Could not synchronize the refresh rate" << std::endl;
                 }
-
-                game.update(io, input);
-                game.draw(io, input, target);
-
-                if (perf_overlay) draw_perf_overlay();
-            });
-            if (not could_sync) {
-                // TODO: Show diagnostic message in the corner or something instead.
-                std::cerr << "Could not synchronize the refresh rate" << std::endl;
             }
 
             SDL_RenderClear(renderer);
 
-            SDL_UpdateTexture(texture, nullptr, target.raw(), u16(target.width() * sizeof(draw::Color)));
-
             if (not SDL_RenderTexture(renderer, texture, nullptr, nullptr)) {
                 throw RunError {
                     RunError::Reason::CouldNotRenderTexture,
@@ -0,0 +1,93 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines the pieces the executor overlaps simulating a tick with drawing the previous one from.
+#pragma once
+#include <primitive>
+#include <atomic>
+#include <thread>
+
+namespace rt {
+    /// Two slots for handing values from one thread to another, one written while the other is read.
+    ///
+    /// The writer fills the back slot and publishes it, which makes it the front. The reader has to be done
+    /// with the previous front by the time the writer publishes again, the executor guarantees this by joining
+    /// both sides every tick, so handing over is a single atomic store.
+    template <typename T> class DoubleBuffer final {
+        T slots[2];
+        /// The slot which was published last, or neither before the first time.
+        std::atomic<u8> published { 2 };
+
+      public:
+        /// The slot the writer fills, never the one being read.
+        auto back() noexcept -> T& {
+            return slots[published.load(std::memory_order_relaxed) == 0 ? 1 : 0];
+        }
+
+        /// Makes the back slot the one being read.
+        void publish() noexcept {
+            published.store(published.load(std::memory_order_relaxed) == 0 ? 1 : 0, std::memory_order_release);
+        }
+
+        /// The slot published last, nothing if nothing was yet.
+        auto front() const noexcept -> T const* {
+            const auto index = published.load(std::memory_order_acquire);
+            return index == 2 ? nullptr : &slots[index];
+        }
+    };
+
+    /// A thread running one job at a time on behalf of another, which carries on with its own work meanwhile.
+    ///
+    /// Handing a job over and waiting for it are an atomic counter each, the thread sleeps on them in between.
+    class Worker final {
+        void (*run)(void*) { nullptr };
+        void* context { nullptr };
+        /// How many jobs were started and finished, they are equal while the worker is idle.
+        std::atomic<u32> started { 0 }, finished { 0 };
+        std::atomic<bool> stopping { false };
+        /// Declared last so that everything it uses is initialized before it starts.
+        std::thread thread;
+
+        void work() {
+            u32 seen = 0;
+            while (true) {
+                started.wait(seen, std::memory_order_acquire);
+                seen = started.load(std::memory_order_acquire);
+                if (stopping.load(std::memory_order_relaxed)) return;
+
+                run(context);
+                finished.store(seen, std::memory_order_release);
+                finished.notify_one();
+            }
+        }
+
+      public:
+        Worker() : thread([this] { work(); }) {}
+
+        Worker(Worker const&) = delete;
+        auto operator=(Worker const&) -> Worker& = delete;
+
+        ~Worker() {
+            stopping.store(true, std::memory_order_relaxed);
+            started.fetch_add(1, std::memory_order_release);
+            started.notify_one();
+            thread.join();
+        }
+
+        /// Starts running a job, which has to stay alive until `wait` returns. The previous job must have been waited for.
+        template <typename F> void start(F& job) {
+            run = [] (void* context) { (*static_cast<F*>(context))(); };
+            context = &job;
+            started.fetch_add(1, std::memory_order_release);
+            started.notify_one();
+        }
+
+        /// Blocks until the job started last is done.
+        void wait() {
+            const auto target = started.load(std::memory_order_relaxed);
+            for (auto done = finished.load(std::memory_order_acquire); done != target; done = finished.load(std::memory_order_acquire)) {
+                finished.wait(done, std::memory_order_acquire);
+            }
+        }
+    };
+}
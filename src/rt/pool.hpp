@@ -0,0 +1,158 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines a small work-stealing thread pool for splitting work like rendering across cores.
+#pragma once
+#include <primitive>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
+
+namespace rt {
+    /// A fixed set of worker threads running the iterations of parallel loops.
+    ///
+    /// Every worker has a queue of its own and so does the calling thread. A loop deals its iterations out across
+    /// all of them, each thread then works through its own queue from the back and once it runs dry steals from
+    /// the front of the others, so uneven iterations even out without a single contended queue.
+    ///
+    /// The calling thread takes part in the loop rather than waiting idle. Loops must not be started from within
+    /// the iterations of another loop.
+    class ThreadPool final {
+        struct Task final {
+            void (*run)(void const*, i32);
+            void const* context;
+            i32 index;
+            std::atomic<i32>* remaining;
+        };
+
+        struct Queue final {
+            std::mutex lock;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::thread> workers;
+        /// One queue per worker followed by the one of the calling thread.
+        std::unique_ptr<Queue[]> queues;
+        usize queue_count;
+
+        std::mutex sleep_lock;
+        std::condition_variable wake;
+        /// Tasks which were queued and not yet taken by anyone.
+        std::atomic<i32> pending { 0 };
+        bool stopping { false };
+
+        /// Takes a task from the back of a queue, or steals one from the front of any other.
+        auto take(usize own, Task& out) -> bool {
+            for (usize i = 0; i < queue_count; i += 1) {
+                auto& queue = queues[(own + i) % queue_count];
+                std::lock_guard guard(queue.lock);
+                if (queue.tasks.empty()) continue;
+
+                if (i == 0) {
+                    out = queue.tasks.back();
+                    queue.tasks.pop_back();
+                } else {
+                    out = queue.tasks.front();
+                    queue.tasks.pop_front();
+                }
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        static void execute(Task const& task) {
+            task.run(task.context, task.index);
+            task.remaining->fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        void work(usize own) {
+            Task task;
+            while (true) {
+                if (take(own, task)) {
+                    execute(task);
+                    continue;
+                }
+
+                std::unique_lock guard(sleep_lock);
+                wake.wait(guard, [this] { return stopping or pending.load(std::memory_order_relaxed) > 0; });
+                if (stopping) return;
+            }
+        }
+
+      public:
+        /// Starts the given number of workers, the calling thread makes one more.
+        explicit ThreadPool(usize worker_count) : queues(new Queue[worker_count + 1]), queue_count(worker_count + 1) {
+            workers.reserve(worker_count);
+            for (usize i = 0; i < worker_count; i += 1) {
+                workers.emplace_back([this, i] { work(i); });
+            }
+        }
+
+        ThreadPool(ThreadPool const&) = delete;
+        auto operator=(ThreadPool const&) -> ThreadPool& = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard guard(sleep_lock);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& worker : workers) worker.join();
+        }
+
+        /// How many threads run the iterations of a loop, including the calling one.
+        auto concurrency() const noexcept -> usize {
+            return queue_count;
+        }
+
+        /// Calls the provided function for every index from 0 up to `count` across the pool and returns once
+        /// every call has, with signature:
+        /// (i32 index) -> void
+        template <typename F> void parallel_for(i32 count, F const& fn) {
+            if (count <= 0) return;
+            if (workers.empty() or count == 1) {
+                for (i32 i = 0; i < count; i += 1) fn(i);
+                return;
+            }
+
+            const auto run = [] (void const* context, i32 index) {
+                (*static_cast<F const*>(context))(index);
+            };
+
+            std::atomic<i32> remaining { count };
+            {
+                std::lock_guard guard(sleep_lock);
+                pending.fetch_add(count, std::memory_order_relaxed);
+            }
+            for (i32 i = 0; i < count; i += 1) {
+                auto& queue = queues[usize(i) % queue_count];
+                std::lock_guard guard(queue.lock);
+                queue.tasks.push_back({ run, &fn, i, &remaining });
+            }
+            wake.notify_all();
+
+            // Help out until every iteration is done, including the ones other threads are still running.
+            const usize own = queue_count - 1;
+            Task task;
+            while (remaining.load(std::memory_order_acquire) > 0) {
+                if (take(own, task)) {
+                    execute(task);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        /// The pool shared by the whole program, with a worker for every core but the calling one.
+        static auto shared() -> ThreadPool& {
+            static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+            return pool;
+        }
+    };
+}
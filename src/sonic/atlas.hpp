@@ -0,0 +1,128 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines the deduplication of the tiles a stage refers to into a compact atlas.
+#pragma once
+#include <primitive>
+#include <draw>
+#include <array>
+#include <vector>
+#include <cstring>
+#include <utility>
+#include <unordered_map>
+
+namespace sonic {
+    using draw::Image;
+    using draw::Color;
+
+    /// The distinct 16x16 tiles used by a stage, where tiles which only differ by mirroring are stored once.
+    ///
+    /// Every tile is compared in all four of its mirrorings and the smallest one is the canonical tile.
+    /// Mirroring is its own inverse and the two axes commute, so a reference to a sheet tile becomes a reference
+    /// to its canonical tile with the mirroring of both combined.
+    class TileAtlas final {
+        using Pixels = std::array<Color, 16 * 16>;
+
+        struct Canonical final {
+            u32 id;
+            bool mirror_x, mirror_y;
+        };
+
+        std::vector<Pixels> tiles;
+        /// The canonical tiles by the hash of their pixels, colliding ones are told apart by comparing the pixels.
+        std::unordered_multimap<u64, u32> by_hash;
+        /// Every sheet tile looked at so far by its position.
+        std::unordered_map<u64, Canonical> by_position;
+
+        static auto hash(Pixels const& pixels) noexcept -> u64 {
+            u64 ret = 0xCBF29CE484222325;
+            for (const auto color : pixels) {
+                ret = (ret ^ (u64(color.r) | u64(color.g) << 8 | u64(color.b) << 16 | u64(color.a) << 24)) * 0x100000001B3;
+            }
+            return ret;
+        }
+
+        static auto mirrored(Pixels const& pixels, bool mirror_x, bool mirror_y) noexcept -> Pixels {
+            Pixels ret;
+            for (i32 y = 0; y < 16; y += 1) {
+                for (i32 x = 0; x < 16; x += 1) {
+                    ret[x + y * 16] = pixels[(mirror_x ? 15 - x : x) + (mirror_y ? 15 - y : y) * 16];
+                }
+            }
+            return ret;
+        }
+
+        template <draw::SizedPlane S> auto canonical(S const& sheet, i32 x, i32 y) -> Canonical {
+            const u64 position = u64(u32(x)) | u64(u32(y)) << 32;
+            if (const auto it = by_position.find(position); it != by_position.end()) return it->second;
+
+            Pixels source;
+            for (i32 py = 0; py < 16; py += 1) {
+                for (i32 px = 0; px < 16; px += 1) {
+                    source[px + py * 16] = sheet.get(x * 16 + px, y * 16 + py);
+                }
+            }
+
+            // Colors have no padding so comparing the bytes is a fine total order.
+            Pixels best = source;
+            bool best_x = false, best_y = false;
+            for (const auto [mx, my] : { std::pair { true, false }, std::pair { false, true }, std::pair { true, true } }) {
+                const auto candidate = mirrored(source, mx, my);
+                if (std::memcmp(candidate.data(), best.data(), sizeof(Pixels)) < 0) {
+                    best = candidate;
+                    best_x = mx;
+                    best_y = my;
+                }
+            }
+
+            const auto key = hash(best);
+            auto ret = Canonical { u32(tiles.size()), best_x, best_y };
+            const auto [first, last] = by_hash.equal_range(key);
+            for (auto it = first; it != last; ++it) {
+                if (tiles[it->second] == best) {
+                    ret.id = it->second;
+                    break;
+                }
+            }
+            if (ret.id == tiles.size()) {
+                tiles.push_back(best);
+                by_hash.emplace(key, ret.id);
+            }
+
+            by_position.emplace(position, ret);
+            return ret;
+        }
+
+      public:
+        /// The width of the atlas in tiles.
+        static constexpr i32 COLUMNS = 16;
+
+        /// Rewrites tile references into a sheet, anything with a position and mirroring like a Tile or SolidTile,
+        /// to refer to the atlas instead. References to no tile at all, at (-1, -1), are left alone.
+        template <draw::SizedPlane S, typename T> void remap(S const& sheet, std::vector<T>& references) {
+            for (auto& reference : references) {
+                if (reference.x == -1 and reference.y == -1) continue;
+
+                const auto tile = canonical(sheet, reference.x, reference.y);
+                reference.x = i32(tile.id) % COLUMNS;
+                reference.y = i32(tile.id) / COLUMNS;
+                reference.mirror_x = reference.mirror_x != tile.mirror_x;
+                reference.mirror_y = reference.mirror_y != tile.mirror_y;
+            }
+        }
+
+        /// How many distinct tiles there are.
+        auto size() const noexcept -> usize {
+            return tiles.size();
+        }
+
+        /// Lays the canonical tiles out in rows of `COLUMNS`.
+        auto image() const -> Image {
+            const i32 rows = (i32(tiles.size()) + COLUMNS - 1) / COLUMNS;
+            return Image(COLUMNS * 16, rows * 16, [this] (i32 x, i32 y) -> Color {
+                const auto id = usize(x / 16 + y / 16 * COLUMNS);
+                return id < tiles.size() ? tiles[id][x % 16 + y % 16 * 16] : draw::color::CLEAR;
+            });
+        }
+    };
+}
@@ -0,0 +1,103 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines a cache of pre-rendered square chunks of an unchanging layer.
+#pragma once
+#include <primitive>
+#include <draw>
+#include <algorithm>
+#include <unordered_map>
+
+namespace sonic {
+    using draw::Image;
+
+    /// Keeps rendered chunks of a layer which never changes, like the foreground tiles of a stage, so that
+    /// a frame blits a handful of chunks rather than every tile on screen.
+    ///
+    /// Chunks are rendered the first time they are asked for and evicted least recently used first
+    /// once the cache grows past its memory budget. Chunks used in the current frame are never evicted,
+    /// so a budget too small for the screen only costs memory, never correctness.
+    ///
+    /// This type is not thread-safe, like the Text cache it is meant to be mutated from const drawing code.
+    class ChunkCache final {
+      public:
+        static constexpr i32 SIZE = 256;
+        static constexpr usize CHUNK_BYTES = usize(SIZE) * SIZE * sizeof(draw::Color);
+
+        struct Chunk final {
+            Image image;
+            usize last_used { 0 };
+            /// Every pixel is opaque so the chunk can be copied rather than blended.
+            bool opaque { false };
+            /// No pixel has any opacity so there is nothing to draw at all.
+            bool empty { false };
+        };
+
+      private:
+        std::unordered_map<u64, Chunk> chunks;
+        usize frame { 0 };
+
+        static constexpr auto key(i32 x, i32 y) noexcept -> u64 {
+            return u64(u32(x)) | u64(u32(y)) << 32;
+        }
+
+      public:
+        /// The most memory the cache should hold on to in bytes.
+        usize budget;
+
+        explicit ChunkCache(usize budget = 16 * 1024 * 1024) : budget(budget) {}
+
+        auto bytes() const noexcept -> usize {
+            return chunks.size() * CHUNK_BYTES;
+        }
+
+        auto contains(i32 x, i32 y) const -> bool {
+            return chunks.find(key(x, y)) != chunks.end();
+        }
+
+        void clear() {
+            chunks.clear();
+        }
+
+        /// Marks the start of a frame, chunks used from now on are protected from eviction until the next one.
+        void next_frame() noexcept {
+            frame += 1;
+        }
+
+        /// Obtains a chunk, rendering it if needed with the provided function of signature:
+        /// (Image& chunk, i32 origin_x, i32 origin_y) -> void
+        ///
+        /// The chunk starts out clear and the origin is the position of its top left pixel in the layer.
+        template <typename F> auto get(i32 x, i32 y, F render) -> Chunk const& {
+            auto [it, inserted] = chunks.try_emplace(key(x, y));
+            auto& chunk = it->second;
+            chunk.last_used = frame;
+
+            if (inserted) {
+                chunk.image = Image(SIZE, SIZE);
+                render(chunk.image, x * SIZE, y * SIZE);
+
+                const auto pixels = chunk.image.raw();
+                const auto count = usize(SIZE) * SIZE;
+                chunk.opaque = std::all_of(pixels, pixels + count, [] (draw::Color c) { return c.a == 255; });
+                chunk.empty = std::none_of(pixels, pixels + count, [] (draw::Color c) { return c.a != 0; });
+                trim();
+            }
+
+            return chunk;
+        }
+
+        /// Evicts the least recently used chunks until the cache fits its budget or only chunks of this frame remain.
+        void trim() {
+            while (bytes() > budget) {
+                auto oldest = chunks.end();
+                for (auto it = chunks.begin(); it != chunks.end(); ++it) {
+                    if (it->second.last_used == frame) continue;
+                    if (oldest == chunks.end() or it->second.last_used < oldest->second.last_used) oldest = it;
+                }
+                if (oldest == chunks.end()) return;
+                chunks.erase(oldest);
+            }
+        }
+    };
+}
@@ -0,0 +1,54 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines a plane recording what is drawn into it, for capturing the debug overlay along with a frame.
+#pragma once
+#include <primitive>
+#include <draw>
+#include <vector>
+
+namespace sonic {
+    /// A pixel drawn by the debug overlay, in stage coordinates.
+    struct DebugPixel final {
+        i32 x, y;
+        draw::Color color;
+    };
+
+    /// A plane which keeps the pixels drawn into it as a list rather than storing an image.
+    ///
+    /// The debug overlay of objects is drawn into one of these when a snapshot is taken, so that it shows the tick
+    /// the snapshot is of and can be drawn over the frame later on. It covers an area of the stage starting
+    /// at its origin, pixels drawn outside of it are dropped like they would be by an image of the same size.
+    /// Like a Ref it only refers to the list, so it is cheap to pass around by value.
+    class DebugCanvas final {
+        std::vector<DebugPixel>* pixels;
+        i32 origin_x, origin_y;
+        i32 w, h;
+
+      public:
+        DebugCanvas(std::vector<DebugPixel>& pixels, i32 origin_x, i32 origin_y, i32 width, i32 height) noexcept
+            : pixels(&pixels), origin_x(origin_x), origin_y(origin_y), w(width), h(height) {}
+
+        auto width() const noexcept -> i32 {
+            return w;
+        }
+
+        auto height() const noexcept -> i32 {
+            return h;
+        }
+
+        /// Nothing is ever read back, the pixels are only drawn over a frame later.
+        auto get(i32 x, i32 y) const noexcept -> draw::Color {
+            return draw::color::CLEAR;
+        }
+
+        void set(i32 x, i32 y, draw::Color color) {
+            if (x >= 0 and x < w and y >= 0 and y < h) {
+                pixels->push_back({ x + origin_x, y + origin_y, color });
+            }
+        }
+    };
+
+    // Assert that our type properly satisfies the desired interface.
+    static_assert(draw::SizedPlane<DebugCanvas> and draw::MutablePlane<DebugCanvas>);
+}
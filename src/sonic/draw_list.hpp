@@ -0,0 +1,93 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines a reusable buffer of draw commands sorted into layers.
+#pragma once
+#include <primitive>
+#include <array>
+#include <vector>
+
+namespace sonic {
+    /// The layers of a frame from back to front, modelled on the priorities of the Genesis.
+    enum class DrawLayer : u8 {
+        Background,
+        LowTiles,
+        Objects,
+        HighTiles,
+        Hud,
+    };
+
+    /// Commands to draw in order of their layer, then their depth, in the order they were added otherwise.
+    ///
+    /// Everything is packed into a 32 bit key which is radix sorted a byte at a time. Passes over a byte
+    /// all the keys share are skipped, so a frame of commands in one layer and depth costs nothing to sort.
+    ///
+    /// The buffers are kept between frames, once they grew large enough for a frame nothing is allocated.
+    template <typename T> class DrawList final {
+        struct Entry final {
+            u32 key;
+            u32 index;
+        };
+
+        std::vector<T> commands;
+        std::vector<Entry> entries, scratch;
+
+      public:
+        /// Forgets every command, keeping the memory.
+        void clear() noexcept {
+            commands.clear();
+            entries.clear();
+        }
+
+        /// Adds a command. A greater depth is further back within a layer.
+        ///
+        /// Commands with the same layer and depth are grouped by their batch, which is how things drawn
+        /// from the same place end up next to each other. Only commands which never overlap should use it,
+        /// otherwise they are no longer drawn in the order they were added.
+        void push(DrawLayer layer, u8 depth, T command, u16 batch = 0) {
+            const u32 key = u32(layer) << 24 | u32(255 - depth) << 16 | batch;
+            entries.push_back({ key, u32(commands.size()) });
+            commands.push_back(command);
+        }
+
+        /// Brings the commands into drawing order, commands with equal keys keep the order they were added in.
+        void sort() {
+            scratch.resize(entries.size());
+
+            for (u32 shift = 0; shift < 32; shift += 8) {
+                std::array<u32, 257> offsets {};
+                for (auto const& entry : entries) offsets[(entry.key >> shift & 0xFF) + 1] += 1;
+
+                // A byte every key shares would leave the order as it is.
+                bool shared = false;
+                for (u32 digit = 1; digit <= 256; digit += 1) {
+                    if (offsets[digit] == entries.size()) shared = true;
+                }
+                if (shared) continue;
+
+                for (u32 digit = 1; digit <= 256; digit += 1) offsets[digit] += offsets[digit - 1];
+                for (auto const& entry : entries) scratch[offsets[entry.key >> shift & 0xFF]++] = entry;
+                entries.swap(scratch);
+            }
+        }
+
+        auto size() const noexcept -> usize {
+            return entries.size();
+        }
+
+        auto empty() const noexcept -> bool {
+            return entries.empty();
+        }
+
+        /// The command at a position of the drawing order, which is only up to date after sorting.
+        auto operator[](usize i) const noexcept -> T const& {
+            return commands[entries[i].index];
+        }
+
+        /// Calls the provided function for every command in drawing order, with signature:
+        /// (T const& command) -> void
+        template <typename F> void each(F fn) const {
+            for (auto const& entry : entries) fn(commands[entry.index]);
+        }
+    };
+}
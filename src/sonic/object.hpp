@@ -5,10 +5,12 @@
 #include <math>
 #include <rt>
 #include <font>
-#include <sstream>
+#include <string>
+#include <optional>
 #include <string_view>
 #include <typeindex>
 #include <unordered_map>
+#include "debug_canvas.hpp"
 
 namespace sonic {
     using draw::Image;
@@ -19,6 +21,7 @@ namespace sonic {
     using math::angle;
 
     class Stage;
+    class ObjectIndex;
 
     /// A dynamic game object.
     ///
@@ -29,8 +32,8 @@ namespace sonic {
     ///   to mess with it using non-deterministic techniques.
     /// - The original games worked like this so it's more accurate.
     /// - It's easy to match updates perfectly evenly to any sane refresh rate (144Hz can go and disappear for all I care).
-    /// - Graphics could be interpolated between updates which I might do later. At that point precision
-    ///   is less important since it doesn't affect the simulation itself.
+    /// - Graphics are interpolated between updates instead, from the position at the start of a tick to the one
+    ///   at its end. Precision is less important there since it doesn't affect the simulation itself.
     ///
     /// The data of an object is a match of the state described in the Sonic Physics Guide.
     /// You could divide this data up over some overengineered inheritance hierarchy
@@ -40,6 +43,7 @@ namespace sonic {
     /// property are likely to cause undefined behavior.
     class Object {
         friend class Stage;
+        friend class ObjectIndex;
 
       public:
         class Trait;
@@ -68,6 +72,13 @@ namespace sonic {
         /// Also, wtf C++ this class is 40 bytes?? This sad library is tempting me to write my own array and map again.
         std::unordered_map<std::type_index, Box<Trait>> traits;
 
+        /// Where the stage's object index keeps this object. The sequence orders objects the same way
+        /// the stage stores them, the cell and slot locate it in the grid for constant time moves and removal.
+        u64 sequence { 0 };
+        u32 cell { 0 };
+        u32 slot { 0 };
+        bool forced { false };
+
       protected:
         /// Assumes a classname. Assume the wrong classname and a reload is likely to end in undefined behavior.
         /// Not having one is fine but the object will not be reconstructed on a hot reload.
@@ -127,6 +138,12 @@ namespace sonic {
         angle ground_angle;
 
       private:
+        /// Where the object was at the start of the last tick it was updated in, frames drawn between ticks
+        /// place it partway from there to its position. Only the stage keeps this.
+        point<fixed> previous_position;
+        /// How many ticks had run by the end of that tick, so that the stage knows whether it was the latest one.
+        usize previous_at { 0 };
+
         /// Internal supertype update which cannot be overriden.
         void managed_update(rt::Input const& input, Stage& stage) {
             for (auto& trait : traits) {
@@ -145,6 +162,10 @@ namespace sonic {
         /// Called once every tick at 60hz.
         virtual void update(rt::Input const& input, Stage& stage) noexcept {}
 
+        /// Called on every active object after all of them were updated, meant for advancing animations.
+        /// Drawing happens from a snapshot and can not change anything, so what `sprite` shows is decided here.
+        virtual void animate(rt::Input const& input) noexcept {}
+
         /// If an instance answers true it will be treated as  active even when out of range.
         /// This is useful for more dynamic constructs.
         ///
@@ -213,6 +234,8 @@ namespace sonic {
             i32 x { 0 }, y { 0 }, w { 0 }, h { 0 };
             bool mirror_x { false }, mirror_y { false };
             u8 rotation { 0 };
+            /// Sprites with a greater depth are drawn further back, ones of equal depth in the order of the objects.
+            u8 depth { 0 };
         };
 
         virtual auto sprite(rt::Input const& input) const noexcept -> Sprite {
@@ -243,13 +266,24 @@ namespace sonic {
             return { 0, 0, 16 };
         }
 
-        /// Called on the primary, meant for drawing the object specific UI.
-        /// The object receives the screen slice to draw into freely.
-        virtual void hud_draw(Io& io, Ref<Image> target, Stage const& stage) const noexcept {}
+        /// What the heads up display shows.
+        struct Hud final {
+            u32 score, timer, rings;
+        };
+
+        /// Called on the primary, the values it answers with are captured along with the rest of a frame
+        /// and shown by the stage. Objects with nothing to show answer with nothing.
+        virtual auto hud() const noexcept -> std::optional<Hud> {
+            return std::nullopt;
+        }
+
+        /// The text of the debug overlay, a line per row.
+        using DebugText = FixedString<1024>;
 
         /// Called when debug drawing is enabled, meant for visualising collision etc.
         /// The object receives the global debug overlay output and the camera slice to draw into freely.
-        virtual void debug_draw(Io& io, std::stringstream& out, draw::Slice<Ref<Image>> target, Stage const& stage) const noexcept {}
+        /// This is called when a snapshot is taken, what is drawn is kept with it and shown over its frame.
+        virtual void debug_draw(DebugText& out, draw::Slice<DebugCanvas> target, Stage const& stage) const noexcept {}
     };
 
     /// Provides default implementations of the dynamic object interface.
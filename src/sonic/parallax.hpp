@@ -0,0 +1,237 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines a cache of the horizontally repeating bands a parallax background is made of,
+// a table of scanlines which lays them out on the screen and a mask of what is hidden behind the layers in front.
+#pragma once
+#include <primitive>
+#include <draw>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+namespace sonic {
+    using draw::Image;
+    using draw::IndexedImage;
+    using draw::Palette;
+    using draw::Color;
+    using draw::Ref;
+    using draw::Surface;
+
+    /// A band of rows of an indexed background which repeats horizontally and scrolls at its own rate.
+    ///
+    /// The rows are kept in color exactly as wide as the source so any offset into the repetition is at most
+    /// two copies of a row when the screen is no wider than the background.
+    ///
+    /// The band is drawn with a palette of its own, so effects like shimmering water are done by changing
+    /// the palette. Only the pixels of entries which actually changed are rewritten, and the pixels using
+    /// an entry are found once, the first time it changes.
+    class ParallaxLayer final {
+        Image pixels;
+        IndexedImage const* source { nullptr };
+        i32 top { 0 };
+        /// The colors the pixels currently show.
+        Palette palette;
+        /// The pixels using each entry, known once `found` is set for it.
+        std::vector<std::vector<u32>> uses;
+        std::vector<bool> found;
+        /// Which entries the band uses at all, its opacity only depends on those.
+        std::vector<bool> present;
+        bool opaque { true };
+
+        void classify() noexcept {
+            opaque = true;
+            for (usize entry = 0; entry < present.size(); entry += 1) {
+                if (present[entry] and palette[u8(entry)].a != 255) opaque = false;
+            }
+        }
+
+      public:
+        /// Copies the band from the source the first time or when the source is a different image,
+        /// then brings it up to date with the palette, which must have the entries of the source's.
+        void prepare(IndexedImage const& source, i32 top, i32 height, Palette const& palette) {
+            const auto indices = source.indices() + top * source.width();
+            const auto count = u32(source.width() * height);
+
+            if (this->source != &source or this->top != top or pixels.height() != height) {
+                this->source = &source;
+                this->top = top;
+                this->palette = palette;
+                pixels = Image(source.width(), height);
+                uses.assign(palette.size(), {});
+                found.assign(palette.size(), false);
+                present.assign(palette.size(), false);
+
+                for (u32 i = 0; i < count; i += 1) {
+                    pixels.raw()[i] = palette[indices[i]];
+                    present[indices[i]] = true;
+                }
+                classify();
+                return;
+            }
+
+            bool changed = false;
+            for (usize entry = 0; entry < palette.size(); entry += 1) {
+                const auto color = palette[u8(entry)];
+                if (color == this->palette[u8(entry)]) continue;
+
+                if (not found[entry]) {
+                    for (u32 i = 0; i < count; i += 1) {
+                        if (indices[i] == entry) uses[entry].push_back(i);
+                    }
+                    found[entry] = true;
+                }
+                for (const auto i : uses[entry]) {
+                    pixels.raw()[i] = color;
+                }
+                this->palette[u8(entry)] = color;
+                changed = true;
+            }
+            if (changed) classify();
+        }
+
+        auto height() const noexcept -> i32 {
+            return pixels.height();
+        }
+
+        /// Draws a row of the band from `x0` up to `x1` of the target with its left edge `offset` pixels into the repetition.
+        void draw_row(Surface target, i32 row, i32 target_y, i32 offset, i32 x0, i32 x1) const {
+            const auto span = target.row_mut(target_y, x0, x1);
+            if (span.empty() or row < 0 or row >= pixels.height()) return;
+
+            const i32 period = pixels.width();
+            const auto source = pixels.raw() + row * period;
+            const auto blend = draw::kernel::active().binary;
+
+            i32 from = math::arithmetic_mod(offset + span.begin, period);
+            for (i32 x = span.begin; x < span.end;) {
+                const i32 count = std::min(period - from, span.end - x);
+                if (opaque) {
+                    std::memcpy(span.data + (x - span.begin), source + from, usize(count) * sizeof(Color));
+                } else {
+                    blend(source + from, span.data + (x - span.begin), count);
+                }
+                x += count;
+                from = 0;
+            }
+        }
+    };
+
+    /// The spans of each line of the screen which something opaque in front is going to cover.
+    ///
+    /// It is built front to back before anything is drawn, so that what is behind can skip the covered spans
+    /// rather than being drawn and then drawn over. Lines past the ones added are not covered at all.
+    class Occlusion final {
+        struct Span final {
+            i32 begin, end;
+        };
+
+        std::vector<Span> spans;
+        /// The spans of line `y` are the ones from `starts[y]` up to `starts[y + 1]`.
+        std::vector<u32> starts { 0 };
+
+      public:
+        void reset() {
+            spans.clear();
+            starts.assign(1, 0);
+        }
+
+        auto height() const noexcept -> i32 {
+            return i32(starts.size()) - 1;
+        }
+
+        /// Covers a span of the current line, spans have to be added from left to right.
+        void cover(i32 begin, i32 end) {
+            if (begin >= end) return;
+            if (spans.size() > starts.back() and spans.back().end >= begin) {
+                spans.back().end = std::max(spans.back().end, end);
+            } else {
+                spans.push_back({ begin, end });
+            }
+        }
+
+        /// Finishes the current line and moves on to the next one.
+        void next_line() {
+            starts.push_back(u32(spans.size()));
+        }
+
+        /// Calls the provided function for every uncovered part of a line from `x0` up to `x1`, with signature:
+        /// (i32 begin, i32 end) -> void
+        template <typename F> void visible(i32 y, i32 x0, i32 x1, F fn) const {
+            i32 x = x0;
+            if (y >= 0 and y < height()) {
+                for (u32 i = starts[y]; i < starts[y + 1] and x < x1; i += 1) {
+                    if (spans[i].begin > x) fn(x, std::min(spans[i].begin, x1));
+                    x = std::max(x, spans[i].end);
+                }
+            }
+            if (x < x1) fn(x, x1);
+        }
+
+        /// Calls the provided function for every covered part of a line, with signature:
+        /// (i32 begin, i32 end) -> void
+        template <typename F> void covered(i32 y, F fn) const {
+            if (y < 0 or y >= height()) return;
+            for (u32 i = starts[y]; i < starts[y + 1]; i += 1) fn(spans[i].begin, spans[i].end);
+        }
+    };
+
+    /// What a single line of the screen shows, a row of a layer scrolled by an offset.
+    struct Scanline final {
+        /// Nothing is drawn on lines without a layer.
+        ParallaxLayer const* layer { nullptr };
+        i32 row { 0 };
+        i32 offset { 0 };
+    };
+
+    /// A table describing every line of the screen, modelled on the horizontal scroll table of the Genesis.
+    ///
+    /// It is filled once per frame and then drawn with a single row copy per line, so effects like the water shear,
+    /// heat haze or an underwater wobble only cost computing an offset per line. Lines can also switch layers, so
+    /// the same band prepared with another palette changes the colors of individual lines.
+    class ScanlineTable final {
+        std::vector<Scanline> lines;
+
+      public:
+        /// Empties the table for a screen of the given height.
+        void reset(i32 height) {
+            lines.assign(std::max(height, 0), {});
+        }
+
+        auto height() const noexcept -> i32 {
+            return i32(lines.size());
+        }
+
+        auto operator[](i32 y) noexcept -> Scanline& {
+            return lines[y];
+        }
+
+        /// Assigns consecutive rows of a layer starting at `row` to the lines starting at `y`, each scrolled by
+        /// the offset computed with the provided function of signature:
+        /// (i32 line) -> i32
+        ///
+        /// The line passed is relative to `y`, lines outside of the table are skipped.
+        template <typename F> void fill(i32 y, i32 count, ParallaxLayer const& layer, i32 row, F offset) {
+            for (i32 i = std::max(-y, 0); i < count and y + i < height(); i += 1) {
+                lines[y + i] = { &layer, row + i, offset(i) };
+            }
+        }
+
+        /// Draws every line, skipping the spans covered by what is in front.
+        void draw(Surface target, Occlusion const& occlusion) const {
+            draw(target, occlusion, 0, target.height());
+        }
+
+        /// Draws the lines from `y0` up to `y1` only, lines are independent so separate ranges can be drawn at the same time.
+        void draw(Surface target, Occlusion const& occlusion, i32 y0, i32 y1) const {
+            for (i32 y = std::max(y0, 0); y < std::min({ y1, height(), target.height() }); y += 1) {
+                auto const& line = lines[y];
+                if (not line.layer) continue;
+
+                occlusion.visible(y, 0, target.width(), [&] (i32 begin, i32 end) {
+                    line.layer->draw_row(target, line.row, y, line.offset, begin, end);
+                });
+            }
+        }
+    };
+}
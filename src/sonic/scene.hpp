@@ -7,10 +7,13 @@
 #include <primitive>
 #include <draw>
 #include <rt>
+#include "snapshot.hpp"
 
 namespace sonic {
     using draw::Image;
+    using draw::IndexedImage;
     using draw::Ref;
+    using draw::Surface;
     using draw::Color;
 
     /// A scene coroutine which can be run.
@@ -20,10 +23,28 @@ namespace sonic {
     struct Scene {
         /// Advances the state by 1/60 of a second.
         virtual void update(Io& io, rt::Input const& input) = 0;
-        /// Called after update to mutate the render target.
-        virtual void draw(
-            Io& io, rt::Input const& input, Ref<Image> target, Ref<const Image> sheet, Ref<const Image> background
+        /// Called after update to capture what the frame is drawn from, for a target of the given size.
+        virtual void snapshot(rt::Input const& input, i32 width, i32 height, Snapshot& out) const = 0;
+        /// Draws a frame from a snapshot. This must not look at the state update changes, so that
+        /// it can run while the next update already does.
+        ///
+        /// The alpha is how far between the tick before the snapshot and the snapshot itself the frame is,
+        /// one draws the snapshot as it is.
+        virtual void render(
+            Io& io, Snapshot const& snapshot, fixed alpha, Surface target, Ref<const IndexedImage> sheet, Ref<const IndexedImage> background
         ) const = 0;
+        /// Draws the debug overlay of a snapshot on top of its frame once it is rendered.
+        virtual void overlay(Io& io, Snapshot const& snapshot, fixed alpha, Surface target) const {}
+
+        /// Called after update to mutate the render target, doing all of the above at once.
+        void draw(
+            Io& io, rt::Input const& input, Surface target, Ref<const IndexedImage> sheet, Ref<const IndexedImage> background
+        ) const {
+            Snapshot frame;
+            snapshot(input, target.width(), target.height(), frame);
+            render(io, frame, 1, target, sheet, background);
+            overlay(io, frame, 1, target);
+        }
         virtual ~Scene() noexcept {}
 
         virtual void hot_reload(Io& io) {}
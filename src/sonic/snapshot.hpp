@@ -0,0 +1,68 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines the snapshot a frame is drawn from.
+#pragma once
+#include <primitive>
+#include <vector>
+#include <optional>
+#include "object.hpp"
+#include "draw_list.hpp"
+
+namespace sonic {
+    /// Everything a frame is drawn from, captured at the end of a tick.
+    ///
+    /// Nothing in here refers back to the simulation, so a frame can be drawn from a snapshot
+    /// while the next tick already runs.
+    struct Snapshot final {
+        /// The size of the target the snapshot was taken for.
+        i32 width { 0 }, height { 0 };
+        /// The offset of the screen into the stage, negative like the shift it is applied with.
+        i32 camera_x { 0 }, camera_y { 0 };
+        /// The same at the end of the tick before, frames drawn between ticks are partway from one to the other.
+        i32 previous_camera_x { 0 }, previous_camera_y { 0 };
+        usize tick { 0 };
+
+        /// A sprite of an object in stage coordinates, with the top left of its cell at the position.
+        struct Sprite final {
+            Object::Sprite sprite;
+            i32 x, y;
+            /// The same at the end of the tick before, or the current position for objects which did not move.
+            i32 previous_x, previous_y;
+        };
+
+        /// The sprites of the visible objects, sorted into drawing order.
+        DrawList<Sprite> sprites;
+        std::optional<Object::Hud> hud;
+        /// Whether the frame may be rasterized across the thread pool.
+        bool parallel { false };
+
+        /// The debug overlay of the tick, captured along with the rest so that it annotates the sprites drawn.
+        struct Debug final {
+            /// What an object drew, the pixels from `first` up to `last`, and its hitbox.
+            /// These move between ticks along with the object, like its sprite.
+            struct Annotation final {
+                u32 first, last;
+                i32 hitbox_x, hitbox_y, hitbox_w, hitbox_h;
+                i32 x, y;
+                i32 previous_x, previous_y;
+            };
+
+            /// Whether the overlay is shown, nothing else is captured otherwise.
+            bool shown { false };
+            bool hitboxes { false };
+            std::vector<Annotation> annotations;
+            std::vector<DebugPixel> pixels;
+            Object::DebugText text;
+        } debug;
+
+        /// Moves from a value of the tick before towards the one of this tick, by the alpha out of one.
+        ///
+        /// This rounds half away from zero, so the steps of the camera and of what it follows cancel out
+        /// exactly and the followed object stays still on screen.
+        static constexpr auto lerp(i32 previous, i32 current, fixed alpha) noexcept -> i32 {
+            const i32 scaled = (current - previous) * fixed::into_raw(alpha);
+            return previous + (scaled >= 0 ? (scaled + 128) >> 8 : -((-scaled + 128) >> 8));
+        }
+    };
+}
@@ -0,0 +1,213 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines the spatial structures a stage uses to avoid looking at every object.
+#pragma once
+#include <primitive>
+#include <vector>
+#include <algorithm>
+#include "object.hpp"
+
+namespace sonic {
+    /// An axis aligned box in stage space with inclusive edges, matching the overlap rules of object hitboxes.
+    struct Bounds final {
+        i32 x { 0 }, y { 0 }, w { 0 }, h { 0 };
+
+        constexpr auto empty() const noexcept -> bool {
+            return w == 0 or h == 0;
+        }
+    };
+
+    /// A uniform grid broadphase hashed into a fixed number of buckets.
+    ///
+    /// It is rebuilt from scratch with a counting sort every tick, which for a few hundred boxes is cheaper than
+    /// maintaining anything incrementally. All the storage is reused between ticks so this does not allocate
+    /// once it has grown to fit the busiest section of a stage.
+    ///
+    /// Boxes are referred to by their index in the slice given to `build`.
+    class Broadphase final {
+        static constexpr i32 CELL_SHIFT = 6;
+        static constexpr u32 BUCKETS = 1024;
+
+        std::vector<Bounds> boxes;
+        std::vector<u32> starts;
+        std::vector<u32> entries;
+        /// The last query each box was reported in, so boxes spanning several cells are reported once.
+        std::vector<u32> seen;
+        u32 query { 0 };
+
+        [[clang::always_inline]] [[gnu::const]]
+        static constexpr auto bucket(i32 cx, i32 cy) noexcept -> u32 {
+            return (u32(cx) * 73856093u ^ u32(cy) * 19349663u) & (BUCKETS - 1);
+        }
+
+        template <typename Fn> static void cells(Bounds const& box, Fn fn) {
+            for (i32 cx = box.x >> CELL_SHIFT; cx <= (box.x + box.w) >> CELL_SHIFT; cx += 1) {
+                for (i32 cy = box.y >> CELL_SHIFT; cy <= (box.y + box.h) >> CELL_SHIFT; cy += 1) {
+                    fn(bucket(cx, cy));
+                }
+            }
+        }
+
+      public:
+        void build(std::vector<Bounds> const& source) {
+            boxes = source;
+            starts.assign(BUCKETS + 1, 0);
+            seen.assign(boxes.size(), 0);
+            query = 0;
+
+            // Empty boxes never overlap anything so they are left out of the grid entirely.
+            for (auto const& box : boxes) {
+                if (box.empty()) continue;
+                cells(box, [&] (u32 b) { starts[b + 1] += 1; });
+            }
+            for (u32 b = 0; b < BUCKETS; b += 1) {
+                starts[b + 1] += starts[b];
+            }
+
+            entries.resize(starts[BUCKETS]);
+            auto cursor = starts;
+            for (u32 i = 0; i < boxes.size(); i += 1) {
+                if (boxes[i].empty()) continue;
+                cells(boxes[i], [&] (u32 b) { entries[cursor[b]++] = i; });
+            }
+        }
+
+        /// Collects every other box sharing a bucket with box `i`, in ascending index order.
+        ///
+        /// This is a superset of the boxes which overlap it, the caller is expected to test the candidates.
+        void candidates(u32 i, std::vector<u32>& out) {
+            out.clear();
+            if (boxes[i].empty()) return;
+
+            query += 1;
+            seen[i] = query;
+            cells(boxes[i], [&] (u32 b) {
+                for (u32 e = starts[b]; e < starts[b + 1]; e += 1) {
+                    const auto other = entries[e];
+                    if (seen[other] == query) continue;
+                    seen[other] = query;
+                    out.push_back(other);
+                }
+            });
+            std::sort(out.begin(), out.end());
+        }
+    };
+
+    /// A persistent coarse grid of the objects in a stage keyed by their pixel position.
+    ///
+    /// Objects outside of the grid are kept in the nearest edge cell, which is fine because queries
+    /// test the exact position of everything they find anyway.
+    ///
+    /// The index also tracks which objects insist on being active regardless of distance. This is polled
+    /// whenever an object could have changed its mind, that is when it is added and after every tick it was active in.
+    class ObjectIndex final {
+        static constexpr i32 CELL_SHIFT = 8;
+
+        std::vector<std::vector<Object*>> cells;
+        std::vector<Object*> forced;
+        i32 columns { 1 }, rows { 1 };
+        u64 next_sequence { 0 };
+
+        auto cell_of(i32 x, i32 y) const noexcept -> u32 {
+            const auto cx = std::clamp(x >> CELL_SHIFT, 0, columns - 1);
+            const auto cy = std::clamp(y >> CELL_SHIFT, 0, rows - 1);
+            return u32(cy + cx * rows);
+        }
+
+        void link(Object* object) {
+            const auto [x, y] = object->pixel_pos();
+            auto& cell = cells[cell_of(x, y)];
+            object->cell = cell_of(x, y);
+            object->slot = u32(cell.size());
+            cell.push_back(object);
+        }
+
+        void unlink(Object* object) noexcept {
+            auto& cell = cells[object->cell];
+            cell[object->slot] = cell.back();
+            cell[object->slot]->slot = object->slot;
+            cell.pop_back();
+        }
+
+        void poll(Object* object) {
+            const auto now = object->force_active();
+            if (now and not object->forced) {
+                forced.push_back(object);
+            } else if (not now and object->forced) {
+                forced.erase(std::find(forced.begin(), forced.end(), object));
+            }
+            object->forced = now;
+        }
+
+      public:
+        ObjectIndex() : cells(1) {}
+
+        /// Sizes the grid to cover a stage of the given size in pixels and inserts the objects in order.
+        void rebuild(i32 width, i32 height, std::vector<Box<Object>> const& objects) {
+            columns = std::max((width + (1 << CELL_SHIFT) - 1) >> CELL_SHIFT, 1);
+            rows = std::max((height + (1 << CELL_SHIFT) - 1) >> CELL_SHIFT, 1);
+            cells.assign(usize(columns) * rows, {});
+            forced.clear();
+            next_sequence = 0;
+
+            for (Box<Object> const& object : objects) {
+                object->forced = false;
+                insert(object.raw());
+            }
+        }
+
+        /// Inserts an object after every object already present.
+        void insert(Object* object) {
+            object->sequence = next_sequence++;
+            link(object);
+            poll(object);
+        }
+
+        void erase(Object* object) noexcept {
+            unlink(object);
+            if (object->forced) {
+                forced.erase(std::find(forced.begin(), forced.end(), object));
+                object->forced = false;
+            }
+        }
+
+        /// Moves an object to its current cell and polls whether it still wants to be forced active.
+        void update(Object* object) {
+            const auto [x, y] = object->pixel_pos();
+            if (cell_of(x, y) != object->cell) {
+                unlink(object);
+                link(object);
+            }
+            poll(object);
+        }
+
+        /// Collects the objects positioned within an inclusive rectangle, optionally along with every forced object,
+        /// in the order the stage stores them.
+        void query(i32 min_x, i32 min_y, i32 max_x, i32 max_y, std::vector<Object*>& out, bool include_forced = false) const {
+            const auto within = [=] (Object const* object) {
+                const auto [x, y] = object->pixel_pos();
+                return x >= min_x and x <= max_x and y >= min_y and y <= max_y;
+            };
+
+            out.clear();
+            if (min_x <= max_x and min_y <= max_y) {
+                const auto first = cell_of(min_x, min_y), last = cell_of(max_x, max_y);
+                for (i32 cx = i32(first) / rows; cx <= i32(last) / rows; cx += 1) {
+                    for (i32 cy = i32(first) % rows; cy <= i32(last) % rows; cy += 1) {
+                        for (const auto object : cells[cy + cx * rows]) {
+                            if (within(object)) out.push_back(object);
+                        }
+                    }
+                }
+            }
+            if (include_forced) {
+                for (const auto object : forced) {
+                    if (not within(object)) out.push_back(object);
+                }
+            }
+
+            std::sort(out.begin(), out.end(), [] (Object const* a, Object const* b) { return a->sequence < b->sequence; });
+        }
+    };
+}
@@ -0,0 +1,159 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines a cache of sprite frames encoded as runs of opaque pixels.
+#pragma once
+#include <primitive>
+#include <draw>
+#include <vector>
+#include <cstring>
+#include <unordered_map>
+#include "object.hpp"
+
+namespace sonic {
+    using draw::Color;
+    using draw::IndexedImage;
+
+    /// A sprite frame reduced to the runs of opaque pixels in each of its rows.
+    ///
+    /// Sprites are drawn with the binary blend, so a transparent pixel never changes anything and an opaque one
+    /// always replaces what is below it. Drawing just the opaque runs with a copy each is therefore exactly the same
+    /// as blending every pixel of the cell, without ever looking at the transparent space around the sprite.
+    class SpriteFrame final {
+        struct Run final {
+            i32 x;
+            i32 length;
+            /// Where the colors of the run start in `pixels`.
+            u32 start;
+        };
+
+        std::vector<Color> pixels;
+        std::vector<Run> runs;
+        /// The runs of row `y` of the trimmed bounds are the ones from `rows[y]` up to `rows[y + 1]`.
+        std::vector<u32> rows;
+        /// The smallest rectangle containing every opaque pixel, relative to the top left of the cell.
+        draw::ClipRect bounds { 0, 0, 0, 0 };
+
+      public:
+        SpriteFrame() = default;
+
+        /// Encodes a sized drawable, only pixels which are fully opaque are kept.
+        template <draw::SizedPlane T> static auto encode(T const& source) -> SpriteFrame {
+            SpriteFrame ret;
+            const i32 w = source.width(), h = source.height();
+
+            auto opaque = [&] (i32 x, i32 y) { return source.get(x, y).a == 255; };
+
+            i32 min_x = w, min_y = h, max_x = -1, max_y = -1;
+            for (i32 y = 0; y < h; y += 1) {
+                for (i32 x = 0; x < w; x += 1) {
+                    if (not opaque(x, y)) continue;
+                    min_x = std::min(min_x, x);
+                    max_x = std::max(max_x, x);
+                    min_y = std::min(min_y, y);
+                    max_y = std::max(max_y, y);
+                }
+            }
+            if (max_x < 0) return ret;
+
+            ret.bounds = { min_x, min_y, max_x - min_x + 1, max_y - min_y + 1 };
+            for (i32 y = min_y; y <= max_y; y += 1) {
+                ret.rows.push_back(u32(ret.runs.size()));
+                for (i32 x = min_x; x <= max_x;) {
+                    if (not opaque(x, y)) {
+                        x += 1;
+                        continue;
+                    }
+                    auto run = Run { x, 0, u32(ret.pixels.size()) };
+                    for (; x <= max_x and opaque(x, y); x += 1) {
+                        ret.pixels.push_back(source.get(x, y));
+                        run.length += 1;
+                    }
+                    ret.runs.push_back(run);
+                }
+            }
+            ret.rows.push_back(u32(ret.runs.size()));
+            return ret;
+        }
+
+        auto empty() const noexcept -> bool {
+            return runs.empty();
+        }
+
+        /// Copies the runs into a target with the top left of the cell at the given position.
+        template <draw::MutableRowPlane T> void draw(T& target, i32 x, i32 y) const {
+            for (i32 row = 0; row < bounds.h; row += 1) {
+                const i32 left = x + bounds.x;
+                const auto span = target.row_mut(y + bounds.y + row, left, left + bounds.w);
+                if (span.empty()) continue;
+
+                for (u32 r = rows[row]; r < rows[row + 1]; r += 1) {
+                    auto const& run = runs[r];
+                    const i32 begin = std::max(x + run.x, span.begin);
+                    const i32 end = std::min(x + run.x + run.length, span.end);
+                    if (begin >= end) continue;
+
+                    std::memcpy(
+                        span.data + (begin - span.begin),
+                        pixels.data() + run.start + (begin - x - run.x),
+                        usize(end - begin) * sizeof(Color)
+                    );
+                }
+            }
+        }
+    };
+
+    /// Keeps every sprite frame drawn so far encoded, keyed by the sheet cell along with its mirroring and rotation.
+    ///
+    /// A game only ever has a limited number of frames so nothing is evicted, the cache is only cleared
+    /// when frames come from a different sheet. This type is not thread-safe.
+    class SpriteCache final {
+        struct Key final {
+            i32 x, y, w, h;
+            bool mirror_x, mirror_y;
+            u8 rotation;
+
+            constexpr auto operator==(Key const&) const noexcept -> bool = default;
+        };
+
+        struct Hash final {
+            auto operator()(Key const& key) const noexcept -> usize {
+                u64 hash = u64(u32(key.x)) | u64(u32(key.y)) << 32;
+                hash ^= (u64(u32(key.w)) | u64(u32(key.h)) << 32) * 0x9E3779B97F4A7C15;
+                hash ^= u64(key.mirror_x) | u64(key.mirror_y) << 1 | u64(key.rotation) << 2;
+                return std::hash<u64>()(hash * 0xBF58476D1CE4E5B9);
+            }
+        };
+
+        std::unordered_map<Key, SpriteFrame, Hash> frames;
+        IndexedImage const* sheet { nullptr };
+
+      public:
+        auto size() const noexcept -> usize {
+            return frames.size();
+        }
+
+        /// Obtains the frame of a sprite, encoding it the first time.
+        auto get(draw::Ref<const IndexedImage> sheet, Object::Sprite const& sprite) -> SpriteFrame const& {
+            if (this->sheet != &sheet.inner) {
+                frames.clear();
+                this->sheet = &sheet.inner;
+            }
+
+            const auto key = Key {
+                sprite.x, sprite.y, sprite.w, sprite.h, sprite.mirror_x, sprite.mirror_y, u8(sprite.rotation % 4)
+            };
+            auto [it, inserted] = frames.try_emplace(key);
+            if (inserted) {
+                auto tilemap = sheet | draw::grid(sprite.w, sprite.h);
+                it->second = SpriteFrame::encode(
+                    tilemap.tile(sprite.x, sprite.y)
+                        | draw::apply_if(sprite.mirror_x, draw::mirror_x())
+                        | draw::apply_if(sprite.mirror_y, draw::mirror_y())
+                        | draw::rotate(i32(sprite.rotation))
+                );
+            }
+            return it->second;
+        }
+    };
+}
@@ -5,22 +5,30 @@
 #pragma once
 #include <primitive>
 #include <rt>
-#include <sstream>
 #include <vector>
 #include <unordered_set>
 #include <functional>
 #include "scene.hpp"
+#include "snapshot.hpp"
 #include "object.hpp"
+#include "terrain.hpp"
+#include "spatial.hpp"
+#include "chunk_cache.hpp"
+#include "parallax.hpp"
+#include "sprite_cache.hpp"
+#include "tileset.hpp"
+#include "atlas.hpp"
+#include "draw_list.hpp"
 #include "class_loader.hpp"
 
 namespace sonic {
     struct DrawCommand {
-        enum class Type : u8 { Tile, Object } type;
+        enum class Type : u8 { Chunk, Annotation } type;
 
-        struct Tile final { i32 x, y; };
-        struct Object final { std::reference_wrapper<const sonic::Object> ref; };
+        struct Chunk final { i32 x, y; };
+        struct Annotation final { u32 index; };
 
-        union { Tile tile; Object object; };
+        union { Chunk chunk; Annotation annotation; };
     };
 
     struct Tile final {
@@ -38,55 +46,68 @@ namespace sonic {
         }
     };
 
-    enum class Solidity : u8 {
-        Full,
-        Top,
-        SidesAndBottom,
-    };
-
-    struct SolidTile final {
-        i32 x { -1 }, y { -1 };
-        angle angle { 0 };
-        Solidity solidity { Solidity::Full };
-        bool flag { false };
-        bool mirror_x { false };
-        bool mirror_y { false };
-
-        constexpr auto empty() const noexcept -> bool {
-            return x == -1 and y == -1;
-        }
-
-        static auto read(rt::BinaryReader& reader) -> SolidTile {
-            const auto x = reader.i32();
-            const auto y = reader.i32();
-            const auto raw_angle = reader.u16();
-            const auto solidity = (Solidity) reader.u8();
-            const auto mirror_x = reader.boolean();
-            const auto mirror_y = reader.boolean();
-
-            return SolidTile {
-                x, y,
-                math::angle(raw_angle),
-                solidity,
-                raw_angle == 360,
-                mirror_x,
-                mirror_y
-            };
-        }
-    };
-
     /// A coroutine class representing the state of a loaded stage.
     class Stage final : public Scene {
-        Ref<const Image> height_tiles;
         u32 width { 0 };
         u32 height { 0 };
+        /// The tiles refer to atlases of just the distinct tiles the stage uses rather than the whole sheets,
+        /// built once at load.
         std::vector<Tile> foreground;
         std::vector<SolidTile> collision;
+        IndexedImage foreground_tiles;
+        Image height_tiles;
+        /// The opacity of every foreground tile, so tiles are drawn without blending every pixel.
+        TileClasses tile_classes;
+        /// Derived from the collision tiles once at load, this is what sensors actually query.
+        HeightArrays terrain;
+        /// The same terrain packed into whole-stage bitmaps, an alternative backend for sensors
+        /// which also answers area and line of sight queries.
+        SolidityBitmap bitmap;
         std::vector<Box<Object>> objects;
+        /// Where the objects are, so that activation and culling do not have to look at all of them.
+        ObjectIndex index;
         std::unordered_set<Object*> removal_queue;
         Object* primary { nullptr };
         usize tick { 0 };
 
+        /// The foreground never changes so it is drawn from pre-rendered chunks, into a layer kept between frames.
+        mutable ChunkCache foreground_chunks;
+        mutable draw::ScrollLayer foreground_layer;
+        /// Neither does the collision, the debug overlay is drawn from chunks of the height tiles and their angles.
+        mutable ChunkCache collision_chunks;
+
+        /// The background strips, kept per parallax rate.
+        mutable ParallaxLayer sky_layer;
+        mutable ParallaxLayer water_layer;
+        /// The water has its own copy of the background palette with the shimmer colors cycled in. Which entries
+        /// cycle is worked out once at load, the copy is only changed when the phase of the shimmer moves on.
+        draw::PaletteCycle water_cycle;
+        mutable draw::Palette water_palette;
+        mutable i32 water_phase { -1 };
+        mutable ScanlineTable scanlines;
+        mutable Occlusion occlusion;
+        /// The opaque pixels of the foreground tiles on screen, a mask for every tile column of every line.
+        /// Opaque tiles are copied out of the foreground layer as the spans they cover, the rest pixel by pixel.
+        mutable std::vector<u16> foreground_masks;
+
+        /// Every sprite frame drawn so far, reduced to its opaque runs.
+        mutable SpriteCache sprites;
+        /// The frames of the objects drawn this frame and where, in drawing order.
+        struct SpriteDraw final {
+            SpriteFrame const* frame;
+            i32 x, y;
+        };
+        mutable std::vector<SpriteDraw> sprite_draws;
+
+        /// Scratch state of capturing snapshots and the debug overlay, kept around so that it does not allocate every frame.
+        mutable std::vector<Object*> visible;
+        mutable DrawList<DrawCommand> debug_commands;
+
+        /// Scratch state of the collision pass, kept around so that it does not allocate every tick.
+        Broadphase broadphase;
+        std::vector<Bounds> hitboxes;
+        std::vector<u32> candidates;
+
         // Some implementation notes:
         //
         // It would be nice for stages to contain an executor objects could schedule coroutines onto (C++20).
@@ -100,6 +121,10 @@ namespace sonic {
         bool visual_debug { false };
         bool movement_debug { false };
         bool hitbox_debug { false };
+        /// Selects the terrain backend sensors query, both give identical answers.
+        bool bitmap_terrain { false };
+        /// Rasterizes the stage in horizontal bands across the shared thread pool.
+        bool parallel_draw { true };
 
         /// Schedules the object for removal at the end of the current update cycle.
         /// It remains valid until then.
@@ -113,6 +138,7 @@ namespace sonic {
         void add(Box<Object>&& object) noexcept {
             // TODO: This can throw, but it makes no sense to propagate to the object.
             objects.emplace_back(std::move(object));
+            index.insert(objects.back().raw());
         }
 
         [[gnu::hot]] [[gnu::const]] auto tile(i32 x, i32 y) const -> Tile {
@@ -137,7 +163,7 @@ namespace sonic {
             }
         }
 
-        Stage(Ref<const Image> height_tiles) : height_tiles(height_tiles) {}
+        Stage() {}
 
         /// We need not remove inactive objects but we have no way of tracing this.
         /// This *is* optimizable if we manage sorting of objects sensibly and store active objects
@@ -148,6 +174,9 @@ namespace sonic {
         ///
         /// This horrible iterator mess can also be significantly cleaned up in C++20.
         void apply_removal_queue() {
+            for (const auto object : removal_queue) {
+                index.erase(object);
+            }
             objects.erase(
                 std::remove_if(objects.begin(), objects.end(),
                     [this] (Box<Object>& box) {
@@ -163,6 +192,8 @@ namespace sonic {
             if (input.key_pressed(rt::Key::Num1)) visual_debug = !visual_debug;
             if (input.key_pressed(rt::Key::Num2)) movement_debug = !movement_debug;
             if (input.key_pressed(rt::Key::Num3)) hitbox_debug = !hitbox_debug;
+            if (input.key_pressed(rt::Key::Num4)) bitmap_terrain = !bitmap_terrain;
+            if (input.key_pressed(rt::Key::Num5)) parallel_draw = !parallel_draw;
 
             const auto [px, py] = primary->pixel_pos();
             static constexpr i32 X_UPDATE_DISTANCE = 320 + 320 / 2;
@@ -172,18 +203,22 @@ namespace sonic {
             //
             // The original resolution is 320x224 so the approximation used will be only processing
             // objects when they are an original screen and a half distance away.
+            // The index hands them over in storage order together with any objects forcing themselves active.
             std::vector<Object*> active_objects;
-            for (Box<Object>& object : objects) {
-                const auto [ox, oy] = object->pixel_pos();
-                if (object->force_active() or std::abs(ox - px) < X_UPDATE_DISTANCE and std::abs(oy - py) < Y_UPDATE_DISTANCE) {
-                    active_objects.push_back(object.raw());
-                }
-            }
+            index.query(
+                px - X_UPDATE_DISTANCE + 1, py - Y_UPDATE_DISTANCE + 1,
+                px + X_UPDATE_DISTANCE - 1, py + Y_UPDATE_DISTANCE - 1,
+                active_objects, true
+            );
 
             // The semantics are defined such that we handle collision first in sorting order on all active objects.
             // Updates follow in the same order but after all the collision. We iterate twice.
-            // Also, the time complexity is silly here *but* it's just nearby objects so we should never hit
-            // any actual scaling issues.
+            //
+            // Comparing every pair got noticeable with scattered rings, so a broadphase narrows each object down
+            // to the others nearby. The candidates come in the same order as the full loop would visit them and
+            // the hitboxes are still tested live, since a collision can take away another object's hitbox
+            // (a ring is collected) before its own turn comes. Collision handlers should not move objects though,
+            // the broadphase only knows where things were at the start of the pass.
             //
             // There is a lifetime concern here. Remember that objects should be able to schedule themselves
             // for removal at the end of the update process, but must not be removed during the update
@@ -203,267 +238,501 @@ namespace sonic {
             // - Unchecked access to an invalidated reference shall throw an exception which the stage will catch and
             //   the then immediately terminate the invalid object and any smart references to it.
             // This is the first and yet unimplemented draft of the approach.
+            hitboxes.clear();
             for (const auto object : active_objects) {
-                for (const auto other : active_objects) {
-                    if (object == other) continue;
+                const auto [x, y, w, h] = object->absolute_hitbox();
+                hitboxes.push_back(Bounds { x, y, w, h });
+            }
+            broadphase.build(hitboxes);
+
+            for (u32 i = 0; i < active_objects.size(); i += 1) {
+                const auto object = active_objects[i];
+                broadphase.candidates(i, candidates);
+                for (const auto j : candidates) {
+                    const auto other = active_objects[j];
                     if (object->absolute_hitbox().overlaps(other->absolute_hitbox())) {
                         object->collide_with(other);
                     }
                 }
             }
+            for (const auto object : active_objects) {
+                object->previous_position = object->position;
+                object->previous_at = tick + 1;
+            }
             for (const auto object : active_objects) {
                 object->managed_update(input, *this);
                 object->update(input, *this);
             }
+            for (const auto object : active_objects) {
+                object->animate(input);
+            }
+
+            // Only active objects could have moved or changed their mind about being forced active.
+            for (const auto object : active_objects) {
+                index.update(object);
+            }
 
             apply_removal_queue();
 
             tick += 1;
         }
 
-        /// We receive three things, an inout mutable image representing the screen to render into,
-        /// another image which is the sprite sheet and one to slice the background from.
-        [[gnu::hot]] void draw(
-            Io& io, rt::Input const& input, Ref<Image> target, Ref<const Image> sheet, Ref<const Image> background
-        ) const override {
-            // We will first assemble a buffer of draw commands, this way we can easily sort before rendering later.
-            std::vector<DrawCommand> commands;
+        /// Where an object was at the start of the latest tick, objects it did not update have not moved since.
+        auto previous_pixel_pos(Object const& object) const noexcept -> math::point<i32> {
+            if (object.previous_at != tick) return object.pixel_pos();
+            return math::point { i32(object.previous_position.x), i32(object.previous_position.y) };
+        }
 
-            const auto [_px, _py] = primary->tile_pos();
-            const auto [_ppx, _ppy] = primary->pixel_pos();
-            const auto camera_buffer = primary->camera_buffer();
+        /// The offset of the screen into the stage with the primary at a position, for a target of the given size.
+        static auto camera(math::point<i32> primary, i32 target_width, i32 target_height) noexcept -> math::point<i32> {
+            return math::point {
+                std::min(-primary.x + target_width / 2, 0),
+                std::max(-primary.y + target_height / 2, -63 * 16 + target_height),
+            };
+        }
 
-            // Because we are using a terrible old C++ version we can't capture structured bindings in lambdas.
-            // That's fine, I'll reassign them, stupid language >:(
-            const auto px = _px, py = _py, ppx = _ppx, ppy = _ppy;
+        /// Captures what a frame is drawn from for a target of the given size.
+        void snapshot(rt::Input const& input, i32 target_width, i32 target_height, Snapshot& out) const override {
+            const auto [camera_x, camera_y] = camera(primary->pixel_pos(), target_width, target_height);
+            const auto [previous_camera_x, previous_camera_y] = camera(previous_pixel_pos(*primary), target_width, target_height);
+
+            out.width = target_width;
+            out.height = target_height;
+            out.camera_x = camera_x;
+            out.camera_y = camera_y;
+            out.previous_camera_x = previous_camera_x;
+            out.previous_camera_y = previous_camera_y;
+            out.tick = tick;
+
+            out.debug.shown = visual_debug;
+            out.debug.hitboxes = hitbox_debug;
+            out.debug.annotations.clear();
+            out.debug.pixels.clear();
+            out.debug.text.clear();
+
+            // The debug overlay is recorded for the screen and a margin around it, which frames drawn
+            // between ticks may see into.
+            constexpr i32 DEBUG_MARGIN = 32;
+            auto debug_target = DebugCanvas(
+                out.debug.pixels,
+                -camera_x - DEBUG_MARGIN, -camera_y - DEBUG_MARGIN,
+                target_width + DEBUG_MARGIN * 2, target_height + DEBUG_MARGIN * 2
+            ) | draw::shift(camera_x + DEBUG_MARGIN, camera_y + DEBUG_MARGIN);
 
-            const i32 camera_x = std::min(-ppx + target.width() / 2, 0);
-            const i32 camera_y = std::max(-ppy + target.height() / 2, -63 * 16 + target.height());
+            // Objects more than a screen away from the edge are not drawn.
+            out.sprites.clear();
+            for (const auto object : visible_objects(out)) {
+                const auto [posx, posy] = object->pixel_pos();
+                const auto [previous_x, previous_y] = previous_pixel_pos(*object);
+                const auto sprite = object->sprite(input);
+                out.sprites.push(DrawLayer::Objects, sprite.depth, {
+                    sprite,
+                    posx - sprite.w / 2, posy - sprite.h / 2,
+                    previous_x - sprite.w / 2, previous_y - sprite.h / 2,
+                });
+
+                if (visual_debug) {
+                    const auto first = u32(out.debug.pixels.size());
+                    object->debug_draw(out.debug.text, debug_target, *this);
+                    const auto hitbox = object->absolute_hitbox();
+                    out.debug.annotations.push_back({
+                        first, u32(out.debug.pixels.size()),
+                        hitbox.x, hitbox.y, hitbox.w, hitbox.h,
+                        posx, posy,
+                        previous_x, previous_y,
+                    });
+                }
+            }
+            out.sprites.sort();
+
+            out.hud = primary->hud();
+            out.parallel = parallel_draw;
+        }
+
+        /// We receive five things, the snapshot to draw, how far past the tick before it to draw it, an inout mutable image
+        /// representing the screen to render into, another image which is the sprite sheet and one to slice the background from.
+        ///
+        /// Only the caches of the drawing side are touched here, so this can run at the same time as the next update.
+        [[gnu::hot]] void render(
+            Io& io, Snapshot const& snapshot, fixed alpha, Surface target, Ref<const IndexedImage> sheet, Ref<const IndexedImage> background
+        ) const override {
+            const i32 camera_x = Snapshot::lerp(snapshot.previous_camera_x, snapshot.camera_x, alpha);
+            const i32 camera_y = Snapshot::lerp(snapshot.previous_camera_y, snapshot.camera_y, alpha);
 
             const auto ccx = -camera_x + target.width() / 2;
-            const auto ccy = -camera_y + target.height() / 2;
 
-            // Rendering into this will draw applying the camera offset automatically.
-            auto camera_target = target
-                | draw::shift(camera_x, camera_y);
+            // We are now ready to start drawing the stage.
 
-            // Obtain all the visible tiles and schedule them for rendering.
-            {
-                const auto tile_width = 16;
-                const auto tile_height = 16;
-
-                const auto half_screen_tiles_x = (i32(target.width()) / tile_width + 2) / 2; // +2 for safety margin
-                const auto half_screen_tiles_y = (i32(target.height()) / tile_height + 2) / 2;
-
-                const auto min_x = std::max(ccx / 16 - half_screen_tiles_x, 0);
-                const auto max_x = std::min(ccx / 16 + half_screen_tiles_x + 1, i32(width));
-                const auto min_y = std::max(ccy / 16 - half_screen_tiles_y, 0);
-                const auto max_y = std::min(ccy / 16 + half_screen_tiles_y + 1, i32(height));
-
-                for (i32 x = min_x; x < max_x; x += 1) {
-                    for (i32 y = min_y; y < max_y; y += 1) {
-                        auto command = DrawCommand { DrawCommand::Type::Tile };
-                        command.tile.x = x;
-                        command.tile.y = y;
-                        commands.push_back(command);
+            // Work out front to back which spans of the screen the foreground is going to cover, the background
+            // never has to touch those. Only rows of tiles which are entirely opaque count.
+            const i32 first_column = math::floor_div(-camera_x, 16);
+            const i32 columns = math::floor_div(target.width() - camera_x - 1, 16) - first_column + 1;
+            foreground_masks.resize(usize(columns * target.height()));
+            occlusion.reset();
+            for (i32 y = 0; y < target.height(); y += 1) {
+                const i32 stage_y = y - camera_y;
+                const i32 ty = math::floor_div(stage_y, 16);
+
+                for (i32 column = 0; column < columns; column += 1) {
+                    const i32 tx = first_column + column;
+                    const u16 mask = foreground_row_mask(tx, ty, stage_y - ty * 16);
+                    foreground_masks[usize(column + y * columns)] = mask;
+                    if (mask == 0xFFFF) {
+                        occlusion.cover(std::max(tx * 16 + camera_x, 0), std::min(tx * 16 + 16 + camera_x, target.width()));
                     }
                 }
+                occlusion.next_line();
             }
 
-            // Schedule objects for rendering as well.
-            // Objects more than a screen away from the edge are not drawn.
+            // The background is made of horizontal strips repeating infinitely, each scrolling at its own rate.
+            // The sky scrolls at 1/32 of the camera and the water at 1/24, where the water below the horizon
+            // also shifts every line a little further, simulating the water having z depth as it gets further away.
+            // The original game did this across individual scanlines.
+            //
+            // The water colors themselves are cycled as that's how the original game creates the effect
+            // of light shimmering across the surface.
+            //
+            // This was all trivial tricks for the original hardware, changing palettes and scrolling between scanlines,
+            // and it is replicated the same way here. The background is indexed so the shimmer is just a change of
+            // its palette, and the strips are kept in a cache which only rewrites the pixels of changed entries,
+            // so every line of the screen is at most two copies.
             {
-                const i32 buffer_x = target.width();
-                const i32 buffer_y = target.height();
-
-                // Visible rectangle in world coordinates.
-                const i32 view_min_x = -camera_x - buffer_x;
-                const i32 view_max_x = -camera_x + target.width() + buffer_x;
-                const i32 view_min_y = -camera_y - buffer_y;
-                const i32 view_max_y = -camera_y + target.height() + buffer_y;
-
-                for (Box<Object> const& object : objects) {
-                    const auto [ox, oy] = object->pixel_pos();
-
-                    if (ox >= view_min_x and ox <= view_max_x and
-                        oy >= view_min_y and oy <= view_max_y
-                    ) {
-                        auto command = DrawCommand { DrawCommand::Type::Object };
-                        command.object.ref = *object;
-                        commands.push_back(command);
-                    }
+                const i32 phase = i32(snapshot.tick / 4) % 4;
+                if (phase != water_phase) {
+                    water_palette.apply(water_cycle, phase);
+                    water_phase = phase;
                 }
+
+                sky_layer.prepare(background.inner, 0, 16 * 7, background.inner.palette());
+                water_layer.prepare(background.inner, 16 * 7, 16 * 9, water_palette);
+
+                // Lay the strips out line by line, the offsets are all that changes between frames.
+                scanlines.reset(target.height());
+                scanlines.fill(0, sky_layer.height(), sky_layer, 0, [ccx] (i32 y) { return ccx / 32; });
+                // The first 2.5 tiles of water are above the horizon and move together.
+                scanlines.fill(16 * 7, 16 * 2 + 8, water_layer, 0, [ccx] (i32 y) { return ccx / 24; });
+                scanlines.fill(16 * 9 + 8, 16 * 6 + 8, water_layer, 16 * 2 + 8, [ccx] (i32 y) {
+                    return ccx / 24 + y * ccx / (16 * 32);
+                });
             }
 
-            // We are now ready to start drawing the stage.
+            // The tiles are below every object so all of the foreground goes first.
+            scroll_foreground(-camera_x, -camera_y, target.width(), target.height());
+
+            // We can now move on to the sorted objects back to front.
+            sprite_draws.clear();
+            snapshot.sprites.each([&] (Snapshot::Sprite const& sprite) {
+                // Only the opaque runs of the frame are copied, the transparent space around it is never visited.
+                const auto& frame = sprites.get(sheet, sprite.sprite);
+                if (not frame.empty()) sprite_draws.push_back({
+                    &frame, Snapshot::lerp(sprite.previous_x, sprite.x, alpha), Snapshot::lerp(sprite.previous_y, sprite.y, alpha)
+                });
+            });
+
+            // Everything so far only prepared the caches, which are not thread-safe. What is left reads them
+            // and writes each line of the target independently, so the target can be split into bands of lines
+            // rasterized at the same time. Every band goes through the layers in the same order as the whole
+            // screen would, so the result does not depend on how it was split.
+            const auto rasterize = [&] (i32 y0, i32 y1) {
+                auto band = target | draw::clip(0, y0, target.width(), y1 - y0);
+
+                // First clear the screen with the water color, just in case the display is taller than the parallax bg.
+                // This is hardcoded for 1-1 at the moment.
+                for (i32 y = y0; y < y1; y += 1) {
+                    occlusion.visible(y, 0, target.width(), [&] (i32 begin, i32 end) {
+                        const auto span = target.row_mut(y, begin, end);
+                        std::fill(span.data, span.data + (span.end - span.begin), Color::rgba(0, 144, 252));
+                    });
+                }
 
-            // First clear the entire screen with the water color, just in case the display is taller than the parallax bg.
-            // This is hardcoded for 1-1 at the moment.
-            target | draw::clear(Color::rgba(0, 144, 252));
+                scanlines.draw(target, occlusion, y0, y1);
 
-            // The background will be drawn by:
-            // - Slicing out the parallax strips from the background in a repeating fashion.
-            // - Slicing a screen-width slice out of the now infinite strip at the parallax x offset.
-            // - Drawing it to the screen at the y offset of the particular strip.
-            //
-            // Remember, the drawable system is fault tolerant by its definition as it describes infinite planes of pixels.
-            // Even an Image has "pixels" out of bounds, they are just not stored and always clear (transparent).
-            // But we can take advantage of this in creative ways and for example repeat the image out of bounds
-            // with a simple functor. Modern compilers do an excellent job of inlining this away and optimizing it out!
-            //
-            // That's not all however. the final water strip is mapped over its color and position
-            // in order to parallax shift individual lines. The original game did this across individual scanlines
-            // simulating the water having z depth as it gets further away in great detail.
-            // But there's more! the water colors themselves are mapped in a cycle
-            // as that's how the original game creates the effect of light shimmering across the surface.
-            //
-            // This was all trivial tricks for the original hardware, changing palettes and scrolling between scanlines,
-            // but it requires either shaders or software processing to make sense in a modern context like this.
-            //
-            // The following code snippet showcases beautifully how powerful this composable rendering abstaction is,
-            // in just a few lines of code this effect is replicated without any existing stateful implementation.
-            // Everything is just made of composable building blocks which can describe anything through intuitive expressions.
-            {
-                // Rotate through these colors for the waterfalls and shimmer.
-                const Color shimmer_colors[4] = {
-                    Color::rgba(108, 144, 180),
-                    Color::rgba(108, 144, 252),
-                    Color::rgba(144, 180, 252),
-                    Color::rgba(180, 216, 252),
-                };
-
-                const auto shimmer_effect = [this, shimmer_colors] (Color color, i32 x, i32 y) -> Color {
-                    const i32 shift = i32(tick / 4) % 4;
-
-                    if (color == Color::rgba(119, 17, 119)) {
-                        return shimmer_colors[(3 + shift) % 4];
-                    } else if (color == Color::rgba(153, 51, 153)) {
-                        return shimmer_colors[(2 + shift) % 4];
-                    } else if (color == Color::rgba(187, 85, 187)) {
-                        return shimmer_colors[(1 + shift) % 4];
-                    } else if (color == Color::rgba(221, 119, 221)) {
-                        return shimmer_colors[(0 + shift) % 4];
-                    } else {
-                        return color;
+                // The foreground goes over it from its layer, the spans it covers as plain copies
+                // and only tiles with holes pixel by pixel.
+                const auto layer = foreground_layer.pixels().raw();
+                for (i32 y = y0; y < y1; y += 1) {
+                    const auto source = layer + y * target.width();
+
+                    occlusion.covered(y, [&] (i32 begin, i32 end) {
+                        const auto span = target.row_mut(y, begin, end);
+                        std::copy(source + span.begin, source + span.end, span.data);
+                    });
+
+                    for (i32 column = 0; column < columns; column += 1) {
+                        const u16 mask = foreground_masks[usize(column + y * columns)];
+                        if (mask == 0 or mask == 0xFFFF) continue;
+
+                        const i32 left = (first_column + column) * 16 + camera_x;
+                        const auto span = target.row_mut(y, left, left + 16);
+                        for (i32 x = span.begin; x < span.end; x += 1) {
+                            if (mask & (1 << (x - left))) span.data[x - span.begin] = source[x];
+                        }
                     }
-                };
-
-                // Tile the background infinitely. Wouldn't want to run out :)
-                auto back = background | draw::repeat();
-
-                target | draw::draw(back | draw::slice(ccx / 32, 0, target.width(), 16 * 2), 0, 0);
-                target | draw::draw(back | draw::slice(ccx / 32, 16 * 2, target.width(), 16 * 1), 0, 16 * 2);
-                target | draw::draw(back | draw::slice(ccx / 32, 16 * 3, target.width(), 16 * 1), 0, 16 * 3);
-                target | draw::draw(back | draw::slice(ccx / 32, 16 * 4, target.width(), 16 * 3), 0, 16 * 4);
-                target | draw::draw(
-                    back
-                        | draw::slice(ccx / 24, 16 * 7, target.width(), 16 * 2 + 8)
-                        | draw::map(shimmer_effect),
-                    0, 16 * 7
-                );
-                target | draw::draw(
-                    back
-                        | draw::slice(ccx / 24, 16 * 9 + 8, target.width(), 16 * 6 + 8)
-                        | draw::map_pos([ccx] (i32 x, i32 y) { return math::point { x + y * ccx / (16 * 32), y }; })
-                        | draw::map(shimmer_effect),
-                    0, 16 * 9 + 8
-                );
+                }
+
+                auto camera_band = band | draw::shift(camera_x, camera_y);
+                for (auto const& sprite : sprite_draws) {
+                    sprite.frame->draw(camera_band, sprite.x, sprite.y);
+                }
+            };
+
+            if (snapshot.parallel) {
+                // A few more bands than threads, so that a thread which finishes early can steal the rest.
+                auto& pool = rt::ThreadPool::shared();
+                const i32 bands = std::min(i32(pool.concurrency()) * 4, std::max(target.height() / 8, 1));
+                const i32 band_height = (target.height() + bands - 1) / bands;
+                pool.parallel_for(bands, [&] (i32 band) {
+                    rasterize(band * band_height, std::min(band * band_height + band_height, target.height()));
+                });
+            } else {
+                rasterize(0, target.height());
+            }
+
+            if (snapshot.hud) draw_hud(io, target, *snapshot.hud);
+        }
+
+        /// Draws the heads up display of the primary.
+        static void draw_hud(Io& io, Surface target, Object::Hud const& hud) {
+            FixedString<64> hud_string;
+            hud_string
+                << "SCORE  " << pad(hud.score, 7) << '\n'
+                << "TIME  " << hud.timer / 60 << ":" << pad(hud.timer % 60, 2, '0') << '\n'
+                << "RINGS  " << pad(hud.rings, 3) << '\n';
+
+            constexpr Color HUD_YELLOW = Color::rgba(255, 255, 10);
+
+            auto const& glyphs = font::glyphs(font::sonic(io));
+
+            i32 y = 8;
+            hud_string.each_line([&] (std::string_view line) {
+                target
+                    | draw::write(glyphs, line, 8 + 1, y + 1, draw::color::BLACK)
+                    | draw::write(glyphs, line, 8 + 1, y, draw::color::BLACK)
+                    | draw::write(glyphs, line, 8, y, HUD_YELLOW);
+                y += font::mine(io).height + 5;
+            });
+        }
+
+        /// The objects within a screen of the view of a snapshot.
+        auto visible_objects(Snapshot const& snapshot) const -> std::vector<Object*> const& {
+            // Visible rectangle in world coordinates.
+            const i32 view_min_x = -snapshot.camera_x - snapshot.width;
+            const i32 view_max_x = -snapshot.camera_x + snapshot.width * 2;
+            const i32 view_min_y = -snapshot.camera_y - snapshot.height;
+            const i32 view_max_y = -snapshot.camera_y + snapshot.height * 2;
+
+            visible.clear();
+            index.query(view_min_x, view_min_y, view_max_x, view_max_y, visible);
+            return visible;
+        }
+
+        /// Draws the debug overlay captured with a snapshot on top of its frame, over the collision of the stage.
+        void overlay(Io& io, Snapshot const& snapshot, fixed alpha, Surface target) const override {
+            if (not snapshot.debug.shown) return;
+
+            const i32 camera_x = Snapshot::lerp(snapshot.previous_camera_x, snapshot.camera_x, alpha);
+            const i32 camera_y = Snapshot::lerp(snapshot.previous_camera_y, snapshot.camera_y, alpha);
+
+            constexpr i32 SIZE = ChunkCache::SIZE;
+
+            // We will first assemble a buffer of draw commands and sort it into layers.
+            // The collision is drawn from chunks which never overlap, so they share a batch.
+            debug_commands.clear();
+            collision_chunks.next_frame();
+
+            const i32 chunks_x = (i32(width) * 16 + SIZE - 1) / SIZE;
+            const i32 chunks_y = (i32(height) * 16 + SIZE - 1) / SIZE;
+            const i32 min_x = std::max(math::floor_div(-camera_x, SIZE), 0);
+            const i32 max_x = std::min(math::floor_div(-camera_x + snapshot.width - 1, SIZE), chunks_x - 1);
+            const i32 min_y = std::max(math::floor_div(-camera_y, SIZE), 0);
+            const i32 max_y = std::min(math::floor_div(-camera_y + snapshot.height - 1, SIZE), chunks_y - 1);
+
+            for (i32 y = min_y; y <= max_y; y += 1) {
+                for (i32 x = min_x; x <= max_x; x += 1) {
+                    auto command = DrawCommand { DrawCommand::Type::Chunk };
+                    command.chunk.x = x;
+                    command.chunk.y = y;
+                    debug_commands.push(DrawLayer::LowTiles, 0, command);
+                }
+            }
+            for (u32 i = 0; i < snapshot.debug.annotations.size(); i += 1) {
+                auto command = DrawCommand { DrawCommand::Type::Annotation };
+                command.annotation.index = i;
+                debug_commands.push(DrawLayer::Objects, 0, command);
             }
+            debug_commands.sort();
 
-            // We can now move on to drawing the sorted tiles and objects back to front.
-            for (const auto command : commands) {
-                if (command.type == DrawCommand::Type::Tile) {
-                    const auto tile = this->tile(command.tile.x, command.tile.y);
+            // Rendering into this will draw applying the camera offset automatically.
+            auto camera_target = target
+                | draw::shift(camera_x, camera_y);
 
-                    auto tilemap = sheet
-                        | draw::grid(16, 16);
+            debug_commands.each([&] (DrawCommand const& command) {
+                if (command.type == DrawCommand::Type::Chunk) {
+                    auto const& chunk = collision_chunks.get(command.chunk.x, command.chunk.y, [&] (Image& chunk, i32 origin_x, i32 origin_y) {
+                        render_collision_chunk(io, chunk, origin_x, origin_y);
+                    });
+                    if (chunk.empty) return;
 
                     camera_target | draw::draw(
+                        Ref<const Image>(chunk.image), command.chunk.x * SIZE, command.chunk.y * SIZE, draw::blend::alpha
+                    );
+                }
+                if (command.type == DrawCommand::Type::Annotation) {
+                    auto const& annotation = snapshot.debug.annotations[command.annotation.index];
+
+                    // Moved between ticks the same way the sprite of the object is.
+                    auto object_target = camera_target | draw::shift(
+                        Snapshot::lerp(annotation.previous_x, annotation.x, alpha) - annotation.x,
+                        Snapshot::lerp(annotation.previous_y, annotation.y, alpha) - annotation.y
+                    );
+
+                    for (u32 i = annotation.first; i < annotation.last; i += 1) {
+                        auto const& pixel = snapshot.debug.pixels[i];
+                        object_target.set(pixel.x, pixel.y, pixel.color);
+                    }
+
+                    if (snapshot.debug.hitboxes) {
+                        object_target | draw::draw(
+                            draw::FilledRectangle {
+                                annotation.hitbox_w,
+                                annotation.hitbox_h,
+                                draw::color::pico::RED,
+                            } | draw::map([] (Color c, i32 x, i32 y) -> Color { return c.with_a(128); }),
+                            annotation.hitbox_x,
+                            annotation.hitbox_y,
+                            draw::blend::alpha
+                        );
+                    }
+                }
+            });
+
+            i32 y = 8;
+            snapshot.debug.text.each_line([&] (std::string_view line) {
+                target | draw::write(font::glyphs(font::mine(io)), line, 8, y);
+                y += font::mine(io).height + font::mine(io).leading;
+            });
+        }
+
+        /// Renders the collision overlay of a chunk, which starts out clear.
+        ///
+        /// Every tile is darkened by its height tile at half opacity, with its angle on top. The label pixels are opaque,
+        /// so blending the chunk over a frame gives exactly what blending each tile and then drawing its label would.
+        void render_collision_chunk(Io& io, Image& chunk, i32 origin_x, i32 origin_y) const {
+            constexpr i32 TILES = ChunkCache::SIZE / 16;
+
+            auto const& labels = font::glyphs(font::pico(io));
+            auto tilemap = Ref<const Image>(height_tiles)
+                | draw::grid(16, 16);
+            auto target = Ref<Image>(chunk);
+
+            for (i32 y = 0; y < TILES; y += 1) {
+                for (i32 x = 0; x < TILES; x += 1) {
+                    const i32 tile_x = origin_x / 16 + x;
+                    const i32 tile_y = origin_y / 16 + y;
+                    if (tile_x >= i32(width) or tile_y >= i32(height)) continue;
+
+                    const auto tile = this->solid_tile(tile_x, tile_y);
+
+                    target | draw::draw(
                         tilemap.tile(tile.x, tile.y)
+                            | draw::map([] (Color color, i32 x, i32 y) -> Color {
+                                return color.with_a(128); // Intentionally increase transparency level too to darken everything.
+                            })
                             | draw::apply_if(tile.mirror_x, draw::mirror_x())
                             | draw::apply_if(tile.mirror_y, draw::mirror_y()),
-                        command.tile.x * 16, command.tile.y * 16
-                    );
-                }
-                if (command.type == DrawCommand::Type::Object) {
-                    Object const& object = command.object.ref.get();
-                    const auto [posx, posy] = object.pixel_pos();
-                    const auto [x, y, w, h, mirror_x, mirror_y, rotation] = object.sprite(input);
-                    const auto ofx = -w / 2;
-                    const auto ofy = -h / 2;
-
-                    auto tilemap = sheet
-                        | draw::grid(w, h);
-                    camera_target | draw::draw(
-                        tilemap.tile(x, y)
-                            | draw::apply_if(mirror_x, draw::mirror_x())
-                            | draw::apply_if(mirror_y, draw::mirror_y())
-                            | draw::rotate(i32(rotation)),
-                        posx + ofx,
-                        posy + ofy
+                        x * 16, y * 16,
+                        draw::blend::overwrite
                     );
+
+                    if (not tile.empty()) {
+                        FixedString<8> label;
+                        if (not tile.flag) label << (u32) tile.angle; else label << "flg";
+                        target | draw::write(labels, label, x * 16, y * 16);
+                    }
                 }
             }
+        }
 
-            // Request the primary to draw the hud.
-            primary->hud_draw(io, target, *this);
+        /// Renders the foreground tiles of a chunk, which starts out clear.
+        void render_chunk(Image& chunk, i32 origin_x, i32 origin_y) const {
+            constexpr i32 TILES = ChunkCache::SIZE / 16;
 
-            // If the debug visuals are enabled draw them as well.
-            if (visual_debug) {
-                std::stringstream out;
+            for (i32 y = 0; y < TILES; y += 1) {
+                for (i32 x = 0; x < TILES; x += 1) {
+                    const auto tile = this->tile(origin_x / 16 + x, origin_y / 16 + y);
+                    if (tile.x == -1 and tile.y == -1) continue;
 
-                for (const auto command : commands) {
-                    if (command.type == DrawCommand::Type::Tile) {
-                        const auto tile = this->solid_tile(command.tile.x, command.tile.y);
+                    tile_classes.draw(foreground_tiles, chunk, tile.x, tile.y, tile.mirror_x, tile.mirror_y, x * 16, y * 16);
+                }
+            }
+        }
 
-                        auto tilemap = height_tiles
-                            | draw::grid(16, 16);
+        /// The opaque pixels of a row of the foreground tile at a tile position.
+        auto foreground_row_mask(i32 x, i32 y, i32 row) const noexcept -> u16 {
+            const auto tile = this->tile(x, y);
+            if (tile.x == -1 and tile.y == -1) return 0;
+            return tile_classes.mask(tile.x, tile.y, row, tile.mirror_x, tile.mirror_y);
+        }
 
-                        camera_target | draw::draw(
-                            tilemap.tile(tile.x, tile.y)
-                                | draw::map([] (Color color, i32 x, i32 y) -> Color {
-                                    return color.with_a(128); // Intentionally increase transparency level too to darken everything.
-                                })
-                                | draw::apply_if(tile.mirror_x, draw::mirror_x())
-                                | draw::apply_if(tile.mirror_y, draw::mirror_y()),
-                            command.tile.x * 16, command.tile.y * 16,
-                            draw::blend::alpha
-                        );
+        /// Brings the foreground layer up to date with a view of the given size positioned at a point of the stage.
+        ///
+        /// The foreground is kept in a layer between frames so only what scrolled into view is drawn again, from cached
+        /// chunks. Afterwards at most one chunk the view is close to is rendered so the camera rarely has to wait on several at once.
+        void scroll_foreground(i32 view_x, i32 view_y, i32 view_width, i32 view_height) const {
+            constexpr i32 SIZE = ChunkCache::SIZE;
 
-                        if (not tile.empty()) {
-                            std::stringstream angle_out;
-                            if (not tile.flag) angle_out << (u32) tile.angle; else angle_out << "flg";
+            foreground_chunks.next_frame();
 
-                            camera_target | draw::draw(
-                                Text(angle_out.str(), font::pico(io)),
-                                command.tile.x * 16, command.tile.y * 16
-                            );
-                        }
-                    }
-                    if (command.type == DrawCommand::Type::Object) {
-                        Object const& object = command.object.ref.get();
-
-                        object.debug_draw(io, out, camera_target, *this);
-
-                        if (hitbox_debug) {
-                            const auto hitbox = object.absolute_hitbox();
-                            camera_target | draw::draw(
-                                draw::FilledRectangle {
-                                    hitbox.w,
-                                    hitbox.h,
-                                    draw::color::pico::RED,
-                                } | draw::map([] (Color c, i32 x, i32 y) -> Color { return c.with_a(128); }),
-                                hitbox.x,
-                                hitbox.y,
-                                draw::blend::alpha
-                            );
-                        }
+            const auto render = [this] (Image& chunk, i32 origin_x, i32 origin_y) {
+                render_chunk(chunk, origin_x, origin_y);
+            };
+
+            const i32 chunks_x = (i32(width) * 16 + SIZE - 1) / SIZE;
+            const i32 chunks_y = (i32(height) * 16 + SIZE - 1) / SIZE;
+
+            // Draws the part of every chunk within an area of the stage.
+            const auto draw_area = [&] (auto layer, i32 area_x, i32 area_y, i32 area_width, i32 area_height) {
+                const i32 min_x = std::max(math::floor_div(area_x, SIZE), 0);
+                const i32 max_x = std::min(math::floor_div(area_x + area_width - 1, SIZE), chunks_x - 1);
+                const i32 min_y = std::max(math::floor_div(area_y, SIZE), 0);
+                const i32 max_y = std::min(math::floor_div(area_y + area_height - 1, SIZE), chunks_y - 1);
+
+                for (i32 y = min_y; y <= max_y; y += 1) {
+                    for (i32 x = min_x; x <= max_x; x += 1) {
+                        auto const& chunk = foreground_chunks.get(x, y, render);
+                        if (chunk.empty) continue;
+
+                        const i32 left = std::max(area_x - x * SIZE, 0);
+                        const i32 top = std::max(area_y - y * SIZE, 0);
+                        const i32 right = std::min(area_x + area_width - x * SIZE, SIZE);
+                        const i32 bottom = std::min(area_y + area_height - y * SIZE, SIZE);
+
+                        layer | draw::draw(
+                            Ref<const Image>(chunk.image) | draw::slice(left, top, right - left, bottom - top),
+                            x * SIZE + left, y * SIZE + top,
+                            chunk.opaque ? draw::blend::overwrite : draw::blend::binary
+                        );
                     }
                 }
+            };
 
-                std::string line;
-                for (i32 y = 8; std::getline(out, line); y += font::mine(io).height + font::mine(io).leading) {
-                    target | draw::draw(Text(line, font::mine(io)), 8, y);
+            foreground_layer.scroll(view_x, view_y, view_width, view_height,
+                [&] (Image& layer, i32 x, i32 y, i32 area_width, i32 area_height) {
+                    draw_area(Ref<Image>(layer) | draw::shift(-view_x, -view_y), view_x + x, view_y + y, area_width, area_height);
+                }
+            );
+
+            const i32 min_x = std::max(math::floor_div(view_x, SIZE), 0);
+            const i32 max_x = std::min(math::floor_div(view_x + view_width - 1, SIZE), chunks_x - 1);
+            const i32 min_y = std::max(math::floor_div(view_y, SIZE), 0);
+            const i32 max_y = std::min(math::floor_div(view_y + view_height - 1, SIZE), chunks_y - 1);
+
+            for (i32 y = std::max(min_y - 1, 0); y <= std::min(max_y + 1, chunks_y - 1); y += 1) {
+                for (i32 x = std::max(min_x - 1, 0); x <= std::min(max_x + 1, chunks_x - 1); x += 1) {
+                    if (not foreground_chunks.contains(x, y)) {
+                        foreground_chunks.get(x, y, render);
+                        return;
+                    }
                 }
             }
         }
@@ -480,19 +749,20 @@ namespace sonic {
             };
         };
 
-        /// Inlining this is rather important, we are doing some composition and this is called in a loop
-        /// so we'd get janky stack shenanigans if we actually called this.
-        ///
-        /// And yes, I checked the assembly, when not inlined the code for this function genuinely is really sad.
+        /// This used to evaluate a whole plane composition over the height tiles for every pixel,
+        /// now that lives in `TileProfile::of` and runs once per distinct tile at load.
         [[clang::always_inline]] [[gnu::hot]] [[gnu::const]] auto solid_at(i32 x, i32 y) const -> bool {
-            const auto tile = solid_tile(x / 16, y / 16);
-            return height_tiles
-                | draw::grid(16, 16)
-                | draw::tile(tile.x, tile.y)
-                | draw::apply_if(tile.mirror_x, draw::mirror_x())
-                | draw::apply_if(tile.mirror_y, draw::mirror_y())
-                | draw::get(x % 16, y % 16)
-                | draw::eq(draw::color::WHITE);
+            return bitmap_terrain ? bitmap.solid(x, y) : terrain.solid(x, y);
+        }
+
+        /// Whether a rectangle in stage space is free of any terrain.
+        [[gnu::hot]] auto empty(i32 x, i32 y, i32 w, i32 h) const -> bool {
+            return bitmap.empty(x, y, w, h);
+        }
+
+        /// Whether a straight line between two points in stage space is free of any terrain.
+        [[gnu::hot]] auto line_of_sight(i32 x0, i32 y0, i32 x1, i32 y1) const -> bool {
+            return bitmap.line_of_sight(x0, y0, x1, y1);
         }
 
         /// The sensor logic is implemented differently, given the significant CPU improvement since then.
@@ -500,55 +770,39 @@ namespace sonic {
         /// At the end of the day objects just want the distance and they do not care if the entire range is consistent
         /// as they always considered only the consistent subrange within. I can't believe I spent days on
         /// this nonsense instead of just doing the obious thing.
+        ///
+        /// The semantics are those of walking pixel by pixel, either regressing out of terrain until an empty pixel
+        /// or extending until the pixel before the terrain, giving up after 32 pixels. The walk itself is answered
+        /// by the height arrays one tile at a time or by the bitmap one word at a time, so a sensor costs
+        /// a handful of lookups.
         [[gnu::const]] auto sense(i32 x, i32 y, SensorDirection direction) const -> SensorResult {
-            i32 cx = x, cy = y;
-
-            const i32 max_distance = 32;
-
-            const auto regress = [&] {
-                switch (direction) {
-                    case SensorDirection::Down:  cy -= 1; break;
-                    case SensorDirection::Right: cx -= 1; break;
-                    case SensorDirection::Up:    cy += 1; break;
-                    case SensorDirection::Left:  cx += 1; break;
-                }
-            };
-
-            const auto extend = [&] {
-                switch (direction) {
-                    case SensorDirection::Down:  cy += 1; break;
-                    case SensorDirection::Right: cx += 1; break;
-                    case SensorDirection::Up:    cy -= 1; break;
-                    case SensorDirection::Left:  cx -= 1; break;
-                }
-            };
+            return bitmap_terrain ? sense(bitmap, x, y, direction) : sense(terrain, x, y, direction);
+        }
 
-            const auto distance = [&] {
-                switch (direction) {
-                    case SensorDirection::Down:  return cy - y;
-                    case SensorDirection::Right: return cx - x;
-                    case SensorDirection::Up:    return y - cy;
-                    case SensorDirection::Left:  return x - cx;
-                }
-            };
+        [[gnu::hot]] auto sense(Terrain auto const& source, i32 x, i32 y, SensorDirection direction) const -> SensorResult {
+            const auto axis = direction == SensorDirection::Down or direction == SensorDirection::Up
+                ? Axis::Vertical
+                : Axis::Horizontal;
+            const i32 step = direction == SensorDirection::Down or direction == SensorDirection::Right ? 1 : -1;
+            const i32 lane = axis == Axis::Vertical ? x : y;
+            const i32 origin = axis == Axis::Vertical ? y : x;
 
-            const auto within_limit = [&] {
-                const auto d = distance();
-                return -32 <= d and d <= 32;
-            };
+            const i32 max_distance = 32;
 
-            // There are two cases, either we are within terrain and we need to regress or we are not inside of terrain
-            // and we need to extend.
-            if (solid_at(cx, cy)) {
-                do regress(); while (solid_at(cx, cy) and within_limit());
+            i32 distance;
+            if (source.solid(x, y)) {
+                const auto empty = source.seek(axis, lane, origin - step, -step, max_distance, false);
+                distance = empty ? (*empty - origin) * step : -(max_distance + 1);
             } else {
-                do extend(); while (not solid_at(cx, cy) and within_limit());
-                regress();
+                const auto solid = source.seek(axis, lane, origin + step, step, max_distance, true);
+                distance = solid ? (*solid - origin) * step - 1 : max_distance;
             }
 
-            const auto tile = solid_tile(cx / 16, cy / 16);
+            const i32 cx = axis == Axis::Horizontal ? x + distance * step : x;
+            const i32 cy = axis == Axis::Vertical ? y + distance * step : y;
+            const auto tile = solid_tile(cx >> 4, cy >> 4);
 
-            return { distance(), tile.angle, tile.flag };
+            return { distance, tile.angle, tile.flag };
         }
 
         [[clang::always_inline]] [[gnu::const]]
@@ -584,6 +838,7 @@ namespace sonic {
 
         /// Visualises a sensor within a target.
         /// The target's origin should align with the relative space origin and need not have size.
+        /// Only the part of the ray within a clipped target, like a slice of the screen, is drawn.
         void sense_draw(Object const* relative_space, i32 x, i32 y, SensorDirection direction, draw::MutablePlane auto target, Color color) const {
             const auto res = sense(relative_space, x, y, direction);
 
@@ -609,10 +864,48 @@ namespace sonic {
             }
         }
 
+        /// Replaces the references into the sheets with references into atlases of the distinct tiles,
+        /// then derives everything else from the tiles.
+        void build_tiles(Ref<const IndexedImage> sheet, Ref<const Image> height_arrays) {
+            TileAtlas foreground_atlas;
+            foreground_atlas.remap(sheet, foreground);
+            // The atlas has a subset of the colors of the sheet so it always fits a palette.
+            foreground_tiles = IndexedImage::from(foreground_atlas.image()).value();
+            tile_classes = TileClasses::of(foreground_tiles);
+
+            TileAtlas collision_atlas;
+            collision_atlas.remap(height_arrays, collision);
+            height_tiles = collision_atlas.image();
+
+            terrain = HeightArrays::build(height_tiles, collision, i32(width), i32(height));
+            bitmap = SolidityBitmap::build(terrain);
+        }
+
         /// Loads a stage from a file using a provided object registry.
+        /// The stage must later be rendered with the same background it was loaded with.
         /// Throws a runtime error if the object class does not exist.
-        static auto load(Io& io, std::string_view filename, Ref<const Image> height_arrays) -> Box<Stage> {
-            auto ret = Box<Stage>::make(height_arrays);
+        static auto load(
+            Io& io, std::string_view filename, Ref<const IndexedImage> sheet, Ref<const Image> height_arrays,
+            Ref<const IndexedImage> background
+        ) -> Box<Stage> {
+            auto ret = Box<Stage>::make();
+
+            // Rotate through these colors for the waterfalls and shimmer, in place of the placeholder colors.
+            static constexpr Color shimmer_placeholders[4] = {
+                Color::rgba(221, 119, 221),
+                Color::rgba(187, 85, 187),
+                Color::rgba(153, 51, 153),
+                Color::rgba(119, 17, 119),
+            };
+            static constexpr Color shimmer_colors[4] = {
+                Color::rgba(108, 144, 180),
+                Color::rgba(108, 144, 252),
+                Color::rgba(144, 180, 252),
+                Color::rgba(180, 216, 252),
+            };
+
+            ret->water_cycle = background.inner.palette().cycle(shimmer_placeholders, shimmer_colors);
+            ret->water_palette = background.inner.palette();
 
             const auto data = io.read_file(filename);
             auto reader = rt::BinaryReader::of(data);
@@ -631,6 +924,8 @@ namespace sonic {
                 ret->collision.push_back(reader.read<SolidTile>());
             }
 
+            ret->build_tiles(sheet, height_arrays);
+
             const auto object_count = reader.u32();
             ret->objects.reserve(object_count);
 
@@ -652,6 +947,8 @@ namespace sonic {
                 reader.seek(position + 1024);
             }
 
+            ret->index.rebuild(i32(ret->width) * 16, i32(ret->height) * 16, ret->objects);
+
             return ret;
         }
 
@@ -673,6 +970,8 @@ namespace sonic {
                     std::swap(object, replacement);
                 }
             }
+            // The index still refers to the replaced instances.
+            index.rebuild(i32(width) * 16, i32(height) * 16, objects);
             apply_removal_queue();
             class_loader::drop_old_object_classes();
         }
@@ -0,0 +1,375 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines the solid terrain of a stage and the structures derived from it
+// at load time in order to make sensing it cheap.
+#pragma once
+#include <primitive>
+#include <math>
+#include <draw>
+#include <rt>
+#include <bit>
+#include <concepts>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+
+namespace sonic {
+    using draw::Image;
+    using draw::Ref;
+    using math::angle;
+
+    enum class Solidity : u8 {
+        Full,
+        Top,
+        SidesAndBottom,
+    };
+
+    struct SolidTile final {
+        i32 x { -1 }, y { -1 };
+        angle angle { 0 };
+        Solidity solidity { Solidity::Full };
+        bool flag { false };
+        bool mirror_x { false };
+        bool mirror_y { false };
+
+        constexpr auto empty() const noexcept -> bool {
+            return x == -1 and y == -1;
+        }
+
+        static auto read(rt::BinaryReader& reader) -> SolidTile {
+            const auto x = reader.i32();
+            const auto y = reader.i32();
+            const auto raw_angle = reader.u16();
+            const auto solidity = (Solidity) reader.u8();
+            const auto mirror_x = reader.boolean();
+            const auto mirror_y = reader.boolean();
+
+            return SolidTile {
+                x, y,
+                math::angle(raw_angle),
+                solidity,
+                raw_angle == 360,
+                mirror_x,
+                mirror_y
+            };
+        }
+    };
+
+    /// The axis a terrain query travels along.
+    enum class Axis : u8 { Horizontal, Vertical };
+
+    /// The collision profile of a single solid tile with its mirroring already applied.
+    ///
+    /// These are the height and width arrays of the original games, except that every entry is a bit mask
+    /// of the solid pixels in its column or row rather than a count. Not every tile in collision.tga is
+    /// solid from an edge, so a count could not reproduce the answers of the old pixel walk.
+    /// Bit n of a column is the pixel in row n, bit n of a row is the pixel in column n.
+    struct TileProfile final {
+        u16 columns[16] {};
+        u16 rows[16] {};
+
+        /// Evaluates the height tile once per pixel, this is the only place the plane composition runs.
+        static auto of(Ref<const Image> height_tiles, SolidTile const& tile) -> TileProfile {
+            TileProfile ret;
+
+            const auto source = height_tiles
+                | draw::grid(16, 16)
+                | draw::tile(tile.x, tile.y)
+                | draw::apply_if(tile.mirror_x, draw::mirror_x())
+                | draw::apply_if(tile.mirror_y, draw::mirror_y());
+
+            for (i32 y = 0; y < 16; y += 1) {
+                for (i32 x = 0; x < 16; x += 1) {
+                    if (source | draw::get(x, y) | draw::eq(draw::color::WHITE)) {
+                        ret.columns[x] |= u16(1 << y);
+                        ret.rows[y] |= u16(1 << x);
+                    }
+                }
+            }
+
+            return ret;
+        }
+
+        [[clang::always_inline]] [[gnu::const]]
+        constexpr auto solid(i32 x, i32 y) const noexcept -> bool {
+            return (columns[x] >> y) & 1;
+        }
+
+        /// The classic height of a column, meaningful for tiles solid from an edge.
+        constexpr auto height(i32 x) const noexcept -> i32 {
+            return std::popcount(columns[x]);
+        }
+
+        /// The classic width of a row, meaningful for tiles solid from an edge.
+        constexpr auto width(i32 y) const noexcept -> i32 {
+            return std::popcount(rows[y]);
+        }
+    };
+
+    /// The height arrays of an entire stage.
+    ///
+    /// Every cell of the stage refers to one of the unique (tile, mirroring) profiles it uses,
+    /// the first profile is always the empty one which is also what lies outside of the stage.
+    /// Cells are stored in the same column-major order as the stage itself.
+    class HeightArrays final {
+        std::vector<TileProfile> profiles;
+        std::vector<u16> cells;
+        i32 w { 0 }, h { 0 };
+
+      public:
+        HeightArrays() : profiles(1) {}
+
+        static auto build(Ref<const Image> height_tiles, std::vector<SolidTile> const& collision, i32 width, i32 height)
+            -> HeightArrays
+        {
+            HeightArrays ret;
+            ret.w = width;
+            ret.h = height;
+            ret.cells.resize(collision.size());
+
+            // There are only a couple hundred distinct tiles and four ways to mirror each of them.
+            std::unordered_map<u64, u16> known;
+
+            for (usize i = 0; i < collision.size(); i += 1) {
+                const auto& tile = collision[i];
+                if (tile.empty()) continue;
+
+                const u64 key = u64(u16(tile.x)) | u64(u16(tile.y)) << 16 | u64(tile.mirror_x) << 32 | u64(tile.mirror_y) << 33;
+
+                if (const auto it = known.find(key); it != known.end()) {
+                    ret.cells[i] = it->second;
+                } else {
+                    const auto index = u16(ret.profiles.size());
+                    ret.profiles.push_back(TileProfile::of(height_tiles, tile));
+                    known.emplace(key, index);
+                    ret.cells[i] = index;
+                }
+            }
+
+            return ret;
+        }
+
+        auto width() const noexcept -> i32 {
+            return w;
+        }
+
+        auto height() const noexcept -> i32 {
+            return h;
+        }
+
+        /// The profile of a tile, tiles outside of the stage are empty.
+        [[clang::always_inline]] [[gnu::hot]]
+        auto profile(i32 x, i32 y) const noexcept -> TileProfile const& {
+            if (x >= 0 and x < w and y >= 0 and y < h) {
+                return profiles[cells[y + x * h]];
+            } else {
+                return profiles[0];
+            }
+        }
+
+        /// Tests a single pixel in stage space. Division is floored so that the space just outside of the
+        /// stage does not alias the first row or column of tiles.
+        [[clang::always_inline]] [[gnu::hot]]
+        auto solid(i32 x, i32 y) const noexcept -> bool {
+            return profile(x >> 4, y >> 4).solid(x & 15, y & 15);
+        }
+
+        /// Finds the first pixel along a lane whose solidity matches, examining at most `count` pixels
+        /// starting at `from` and moving by `step` which must be either 1 or -1.
+        ///
+        /// The lane is the fixed coordinate, so a column x for vertical travel or a row y for horizontal travel.
+        /// Each tile along the way is answered by a single masked bit scan.
+        [[gnu::hot]]
+        auto seek(Axis axis, i32 lane, i32 from, i32 step, i32 count, bool solid) const noexcept -> std::optional<i32> {
+            const i32 lane_tile = lane >> 4, lane_bit = lane & 15;
+
+            i32 p = from;
+            while (count > 0) {
+                const i32 t = p >> 4, local = p & 15;
+
+                u32 mask = axis == Axis::Vertical
+                    ? profile(lane_tile, t).columns[lane_bit]
+                    : profile(t, lane_tile).rows[lane_bit];
+                if (not solid) mask = ~mask & 0xFFFF;
+
+                if (step > 0) {
+                    const i32 span = std::min(16 - local, count);
+                    const u32 window = (mask >> local) & ((1u << span) - 1);
+                    if (window) return p + std::countr_zero(window);
+                    p += span;
+                    count -= span;
+                } else {
+                    // Align the current pixel with the top bit so we can scan downwards with a leading zero count.
+                    const i32 span = std::min(local + 1, count);
+                    const u32 window = (mask << (15 - local)) & (0xFFFFu << (16 - span)) & 0xFFFF;
+                    if (window) return p - (std::countl_zero(window) - 16);
+                    p -= span;
+                    count -= span;
+                }
+            }
+
+            return std::nullopt;
+        }
+    };
+
+    /// The solidity of an entire stage packed one bit per pixel, with mirroring resolved at load.
+    ///
+    /// The same pixels are stored twice, row-major for horizontal travel and column-major for vertical travel,
+    /// so that a query along either axis reads consecutive bits of 64 bit words. Everything outside is empty,
+    /// which includes the padding at the end of every row and column.
+    class SolidityBitmap final {
+        std::vector<u64> rows;
+        std::vector<u64> columns;
+        i32 w { 0 }, h { 0 };
+        i32 row_words { 0 }, column_words { 0 };
+
+        [[clang::always_inline]] [[gnu::hot]]
+        auto word(Axis axis, i32 lane, i32 index) const noexcept -> u64 {
+            if (axis == Axis::Horizontal) {
+                if (lane < 0 or lane >= h or index < 0 or index >= row_words) return 0;
+                return rows[usize(lane) * row_words + index];
+            } else {
+                if (lane < 0 or lane >= w or index < 0 or index >= column_words) return 0;
+                return columns[usize(lane) * column_words + index];
+            }
+        }
+
+      public:
+        SolidityBitmap() = default;
+
+        static auto build(HeightArrays const& terrain) -> SolidityBitmap {
+            SolidityBitmap ret;
+            ret.w = terrain.width() * 16;
+            ret.h = terrain.height() * 16;
+            ret.row_words = (ret.w + 63) / 64;
+            ret.column_words = (ret.h + 63) / 64;
+            ret.rows.resize(usize(ret.h) * ret.row_words);
+            ret.columns.resize(usize(ret.w) * ret.column_words);
+
+            // Tiles are 16 pixels wide and aligned so every row or column of a tile lands within a single word.
+            for (i32 tx = 0; tx < terrain.width(); tx += 1) {
+                for (i32 ty = 0; ty < terrain.height(); ty += 1) {
+                    auto const& profile = terrain.profile(tx, ty);
+
+                    for (i32 i = 0; i < 16; i += 1) {
+                        const i32 x = tx * 16 + i, y = ty * 16 + i;
+                        ret.rows[usize(y) * ret.row_words + (tx * 16) / 64] |= u64(profile.rows[i]) << (tx * 16 % 64);
+                        ret.columns[usize(x) * ret.column_words + (ty * 16) / 64] |= u64(profile.columns[i]) << (ty * 16 % 64);
+                    }
+                }
+            }
+
+            return ret;
+        }
+
+        auto width() const noexcept -> i32 {
+            return w;
+        }
+
+        auto height() const noexcept -> i32 {
+            return h;
+        }
+
+        [[clang::always_inline]] [[gnu::hot]]
+        auto solid(i32 x, i32 y) const noexcept -> bool {
+            return (word(Axis::Horizontal, y, x >> 6) >> (x & 63)) & 1;
+        }
+
+        /// Finds the first pixel along a lane whose solidity matches, examining at most `count` pixels
+        /// starting at `from` and moving by `step` which must be either 1 or -1.
+        ///
+        /// This has the same contract as `HeightArrays::seek` but answers up to 64 pixels per bit scan.
+        [[gnu::hot]]
+        auto seek(Axis axis, i32 lane, i32 from, i32 step, i32 count, bool solid) const noexcept -> std::optional<i32> {
+            i32 p = from;
+            while (count > 0) {
+                const i32 index = p >> 6, local = p & 63;
+
+                u64 mask = word(axis, lane, index);
+                if (not solid) mask = ~mask;
+
+                if (step > 0) {
+                    const i32 span = std::min(64 - local, count);
+                    u64 window = mask >> local;
+                    if (span < 64) window &= (u64(1) << span) - 1;
+                    if (window) return p + std::countr_zero(window);
+                    p += span;
+                    count -= span;
+                } else {
+                    const i32 span = std::min(local + 1, count);
+                    u64 window = mask << (63 - local);
+                    if (span < 64) window &= ~u64(0) << (64 - span);
+                    if (window) return p - std::countl_zero(window);
+                    p -= span;
+                    count -= span;
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        /// Whether a rectangle in stage space contains no solid pixels at all.
+        [[gnu::hot]]
+        auto empty(i32 x, i32 y, i32 width, i32 height) const noexcept -> bool {
+            if (width <= 0 or height <= 0) return true;
+
+            for (i32 row = std::max(y, 0); row < std::min(y + height, h); row += 1) {
+                if (seek(Axis::Horizontal, row, x, 1, width, true)) return false;
+            }
+            return true;
+        }
+
+        /// Whether the line between two points, inclusive of both, passes through no solid pixels.
+        ///
+        /// The line is rasterized exactly like `draw::line` so it can be visualized faithfully,
+        /// but every straight run of it is tested as a whole against the bitmap of its major axis.
+        [[gnu::hot]]
+        auto line_of_sight(i32 x0, i32 y0, i32 x1, i32 y1) const noexcept -> bool {
+            const i32 delta_x = std::abs(x1 - x0);
+            const i32 delta_y = std::abs(y1 - y0);
+            const i32 step_x = x0 < x1 ? 1 : -1;
+            const i32 step_y = y0 < y1 ? 1 : -1;
+            i32 err = delta_x - delta_y;
+
+            // Runs travel along the major axis, the lane being the minor coordinate.
+            const auto axis = delta_x >= delta_y ? Axis::Horizontal : Axis::Vertical;
+            const i32 step = axis == Axis::Horizontal ? step_x : step_y;
+
+            i32 lane = axis == Axis::Horizontal ? y0 : x0;
+            i32 start = axis == Axis::Horizontal ? x0 : y0;
+            i32 end = start;
+
+            while (true) {
+                if (x0 == x1 and y0 == y1) break;
+                const i32 e2 = 2 * err;
+                if (e2 > -delta_y) {
+                    err -= delta_y;
+                    x0 += step_x;
+                }
+                if (e2 < delta_x) {
+                    err += delta_x;
+                    y0 += step_y;
+                }
+
+                const i32 minor = axis == Axis::Horizontal ? y0 : x0;
+                const i32 major = axis == Axis::Horizontal ? x0 : y0;
+                if (minor == lane and major == end + step) {
+                    end = major;
+                } else {
+                    if (seek(axis, lane, start, step, (end - start) * step + 1, true)) return false;
+                    lane = minor;
+                    start = end = major;
+                }
+            }
+
+            return not seek(axis, lane, start, step, (end - start) * step + 1, true);
+        }
+    };
+
+    /// Anything a stage can sense terrain through.
+    template <typename T> concept Terrain = requires (T const& self, Axis axis, i32 i) {
+        { self.solid(i, i) } -> std::same_as<bool>;
+        { self.seek(axis, i, i, i, i, true) } -> std::same_as<std::optional<i32>>;
+    };
+}
@@ -0,0 +1,121 @@
+// Created by Lua (TeamPuzel) on October 16th 2026.
+// Copyright (c) 2026 All rights reserved.
+//
+// This header defines how the tiles of a sheet are classified by their opacity.
+#pragma once
+#include <primitive>
+#include <draw>
+#include <array>
+#include <vector>
+#include <algorithm>
+
+namespace sonic {
+    using draw::Color;
+    using draw::IndexedImage;
+
+    enum class TileOpacity : u8 {
+        /// No pixel is opaque, drawing the tile changes nothing.
+        Empty,
+        /// Every pixel is opaque, the tile replaces whatever is below it.
+        Opaque,
+        /// Anything else, only some pixels of some rows are drawn.
+        Mixed,
+    };
+
+    /// The opacity of every 16x16 tile of a sheet along with a mask of the opaque pixels of each row.
+    ///
+    /// Tiles are drawn with the binary blend, so knowing which pixels are opaque is all it takes to draw one exactly:
+    /// empty tiles are skipped, opaque rows are copied and only rows with both kinds of pixels are looked at closer.
+    class TileClasses final {
+        using Masks = std::array<u16, 16>;
+
+        std::vector<TileOpacity> kinds;
+        /// Bit `x` of row `y` is set when that pixel is opaque.
+        std::vector<Masks> masks;
+        i32 columns { 0 }, rows { 0 };
+
+        auto index(i32 x, i32 y) const noexcept -> usize {
+            return usize(y + x * rows);
+        }
+
+      public:
+        static auto of(IndexedImage const& sheet) -> TileClasses {
+            TileClasses ret;
+            ret.columns = sheet.width() / 16;
+            ret.rows = sheet.height() / 16;
+            ret.kinds.resize(usize(ret.columns) * ret.rows);
+            ret.masks.resize(usize(ret.columns) * ret.rows);
+
+            Color line[16];
+            for (i32 x = 0; x < ret.columns; x += 1) {
+                for (i32 y = 0; y < ret.rows; y += 1) {
+                    auto& masks = ret.masks[ret.index(x, y)];
+                    bool any = false, all = true;
+
+                    for (i32 row = 0; row < 16; row += 1) {
+                        sheet.row(y * 16 + row, x * 16, x * 16 + 16, line);
+                        u16 mask = 0;
+                        for (i32 i = 0; i < 16; i += 1) {
+                            if (line[i].a == 255) mask |= u16(1 << i);
+                        }
+                        masks[row] = mask;
+                        any = any or mask != 0;
+                        all = all and mask == 0xFFFF;
+                    }
+
+                    ret.kinds[ret.index(x, y)] = all ? TileOpacity::Opaque : any ? TileOpacity::Mixed : TileOpacity::Empty;
+                }
+            }
+            return ret;
+        }
+
+        /// Tiles outside of the sheet are empty.
+        auto kind(i32 x, i32 y) const noexcept -> TileOpacity {
+            if (x < 0 or x >= columns or y < 0 or y >= rows) return TileOpacity::Empty;
+            return kinds[index(x, y)];
+        }
+
+        /// The mask of a row of a tile as it appears after mirroring.
+        auto mask(i32 x, i32 y, i32 row, bool mirror_x, bool mirror_y) const noexcept -> u16 {
+            if (x < 0 or x >= columns or y < 0 or y >= rows) return 0;
+
+            const u16 mask = masks[index(x, y)][mirror_y ? 15 - row : row];
+            if (not mirror_x) return mask;
+
+            u16 reversed = 0;
+            for (i32 i = 0; i < 16; i += 1) {
+                if (mask & (1 << i)) reversed |= u16(1 << (15 - i));
+            }
+            return reversed;
+        }
+
+        /// Draws a tile of the sheet with the binary blend. Only rows of the target fully within it are supported,
+        /// which is always the case for tiles aligned to chunks.
+        template <draw::MutableRowPlane T> void draw(
+            IndexedImage const& sheet, T& target, i32 tile_x, i32 tile_y, bool mirror_x, bool mirror_y, i32 x, i32 y
+        ) const {
+            if (kind(tile_x, tile_y) == TileOpacity::Empty) return;
+
+            Color line[16];
+            for (i32 row = 0; row < 16; row += 1) {
+                const auto mask = this->mask(tile_x, tile_y, row, mirror_x, mirror_y);
+                if (mask == 0) continue;
+
+                const auto span = target.row_mut(y + row, x, x + 16);
+                if (span.begin != x or span.end != x + 16) continue;
+
+                const i32 source_row = mirror_y ? 15 - row : row;
+                sheet.row(tile_y * 16 + source_row, tile_x * 16, tile_x * 16 + 16, line);
+                if (mirror_x) std::reverse(line, line + 16);
+
+                if (mask == 0xFFFF) {
+                    std::copy(line, line + 16, span.data);
+                } else {
+                    for (i32 i = 0; i < 16; i += 1) {
+                        if (mask & (1 << i)) span.data[i] = line[i];
+                    }
+                }
+            }
+        }
+    };
+}